@@ -0,0 +1,137 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <gmp.h>
+#include <mpfr.h>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/types.h>
+
+// bump allocator behind the memory functions of GMP, which MPFR and MPFI use for their temporaries: while an
+// ArenaScope is open (one per leaf), every thread allocates from its own chunk of a region of address space that is
+// reserved once, and freeing does nothing but count; when the last scope is closed and every block of the chunk has
+// been freed, the chunk starts over. A block that outlives the scope (e.g., a constant that MPFR caches, see
+// mpfr_fillcaches) keeps its chunk, and the thread takes a new one. Allocations outside of a scope, large ones and
+// those after the region is used up go to the previous memory functions, as does their memory when it is freed or
+// reallocated.
+
+static const size_t arenacapacity = size_t(1) << 36; // address space for the chunks of all threads
+static const size_t arenachunk = size_t(1) << 20;
+static const size_t arenamaximum = size_t(1) << 16; // larger blocks are not taken from the chunk
+static const size_t arenaalignment = 16;
+
+struct arena_t {
+    char *chunk = nullptr;
+    size_t used = 0;
+    uint64_t live = 0; // blocks in the chunk that this thread has not seen freed
+    uint scopes = 0;
+};
+
+static char *arenaregion = nullptr;
+static std::atomic<size_t> arenataken{0};
+static thread_local arena_t arena;
+static void *(*arenaallocatenext)(size_t);
+static void *(*arenareallocatenext)(void *, size_t, size_t);
+static void (*arenafreenext)(void *, size_t);
+
+static inline bool arenacontains(const char *begin, size_t size, const void *pointer)
+{
+    return (begin != nullptr) && (static_cast<const char *>(pointer) >= begin) && (static_cast<const char *>(pointer) < begin + size);
+}
+
+static inline void *arenaallocate(size_t size)
+{
+    const size_t rounded = (std::max(size, size_t(1)) + arenaalignment - 1) & ~(arenaalignment - 1);
+
+    if ((arena.scopes == 0) || (rounded > arenamaximum)) {
+        return arenaallocatenext(size);
+    }
+
+    if ((arena.chunk == nullptr) || (arena.used + rounded > arenachunk)) {
+        // the blocks in the previous chunk stay valid, and the region is never given back
+
+        const size_t offset = arenataken.fetch_add(arenachunk);
+        arena.chunk = (offset + arenachunk <= arenacapacity) ? arenaregion + offset : nullptr;
+        arena.used = 0;
+        arena.live = 0;
+
+        if (arena.chunk == nullptr) {
+            return arenaallocatenext(size);
+        }
+    }
+
+    char *block = arena.chunk + arena.used;
+    arena.used += rounded;
+    ++arena.live;
+    return block;
+}
+
+static inline void arenafree(void *pointer, size_t size)
+{
+    if (!arenacontains(arenaregion, arenacapacity, pointer)) {
+        arenafreenext(pointer, size);
+    } else if (arenacontains(arena.chunk, arenachunk, pointer) && (arena.live > 0)) {
+        --arena.live;
+    }
+}
+
+static inline void *arenareallocate(void *pointer, size_t oldsize, size_t size)
+{
+    if (!arenacontains(arenaregion, arenacapacity, pointer)) {
+        return arenareallocatenext(pointer, oldsize, size);
+    }
+
+    void *block = arenaallocate(size);
+    memcpy(block, pointer, std::min(oldsize, size));
+    arenafree(pointer, oldsize);
+    return block;
+}
+
+// installs the arena once for the whole program; without the address space, everything goes to the previous memory
+// functions
+
+static inline void arenainstall()
+{
+    static std::once_flag installed;
+
+    std::call_once(installed, []() {
+        void *reservation = mmap(nullptr, arenacapacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+        if (reservation == MAP_FAILED) {
+            return;
+        }
+
+        arenaregion = static_cast<char *>(reservation);
+        mp_get_memory_functions(&arenaallocatenext, &arenareallocatenext, &arenafreenext);
+        mp_set_memory_functions(arenaallocate, arenareallocate, arenafree);
+    });
+}
+
+class ArenaScope
+{
+  public:
+    ArenaScope() { ++arena.scopes; }
+
+    ~ArenaScope()
+    {
+        // MPFR keeps the numbers of its temporary integers in a pool, which is emptied here; a chunk with blocks that
+        // still outlive the scope is left to them, and the next scope takes a new one
+
+        if (--arena.scopes == 0) {
+            mpfr_free_pool();
+            arena.used = 0;
+            arena.chunk = (arena.live == 0) ? arena.chunk : nullptr;
+        }
+    }
+
+  private:
+    ArenaScope(const ArenaScope &) = delete;
+    ArenaScope &operator=(const ArenaScope &) = delete;
+};
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef ARGUMENTS_H
+#define ARGUMENTS_H
+
+#include <cerrno>
+#include <cstdlib>
+#include <sys/types.h>
+
+// the largest counts that the programs accept on the command line: more threads than cores only cost memory, and
+// every shard of generatewl is an open file
+
+static const uint maximumthreads = 1024;
+static const uint maximumshards = 256;
+
+// a count on the command line (e.g., of --threads N), which has to be a decimal number up to maximum as a whole, so
+// that neither "x" nor "-1" (which strtoul would wrap around) is taken; returns false otherwise
+
+static inline bool parsecount(const char *string, uint maximum, uint &count)
+{
+    char *end = nullptr;
+    errno = 0;
+    const unsigned long value = strtoul(string, &end, 10);
+
+    if ((string[0] < '0') || (string[0] > '9') || (*end != '\0') || (errno != 0) || (value > maximum)) {
+        return false;
+    }
+
+    count = uint(value);
+    return true;
+}
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef BACKEND_H
+#define BACKEND_H
+
+#include "check.h"
+
+// the verifiers are templates over a number backend, a struct with a number type number_t and static functions that
+// mirror the MPFR/MPFI calls of the verification:
+//
+//   set, setsi, setstr, setui2exp, setzero, setinf
+//   add, sub, sisub, mul, div, divsi, div2si, neg, log, exp, min
+//   cmp, cmpsi, cmpd, bounded, regular, iszero, snprintf, get2exp
+//
+// every arithmetic function takes the direction in which the value is needed: a backend with directed rounding (MPFR)
+// rounds accordingly and checks that exact operations are exact, while an interval backend (MPFI, double-double)
+// ignores the direction and returns an enclosure; snprintf prints the lower or upper end of the value, and get2exp
+// returns it rounded in that direction to 63 bits, as mantissa * 2^exponent with 2^62 <= |mantissa| < 2^63 (or 0)
+
+enum rounding_t { exact, down, up };
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <cstdlib>
+
+#define CHECK(condition)    \
+    do {                    \
+        if (!(condition)) { \
+            abort();        \
+        }                   \
+    } while (false)
+
+#endif
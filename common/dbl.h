@@ -0,0 +1,150 @@
+#ifndef DBL_H
+#define DBL_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <sys/types.h>
+
+// bounds in plain double precision for the batched verification: every operation is computed in the default rounding
+// mode (to nearest) and its result is then moved outward by more than its rounding error, and exp and log are
+// evaluated without the C library (which is only used for a first guess of log), so that the bounds are rigorous;
+// the functions have no branches, so that loops over several independent values can be vectorized
+
+static const double dblstep = std::ldexp(1.0, -51);       // relative, at least twice the half ulp of a result
+static const double dbltiny = std::ldexp(1.0, -1074);     // absolute, the rounding error of a subnormal result
+static const double dblexprelative = std::ldexp(1.0, -44); // exp, see dbl_expapprox
+static const double dblexpmax = 700;                       // below the overflow of exp
+static const double dblln2hi = 6.93147180369123816490e-01; // 32 bits, so that k * dblln2hi is exact for |k| < 2^20
+static const double dblln2lo = 1.90821492927058770002e-10; // log(2) - dblln2hi
+
+// a lower (upper) bound of a value that was computed with a single rounding to nearest
+
+static inline double dbl_down(double a)
+{
+    return a - std::fabs(a) * dblstep - dbltiny;
+}
+
+static inline double dbl_up(double a)
+{
+    return a + std::fabs(a) * dblstep + dbltiny;
+}
+
+static std::array<double, 15> dbl_expcoefficients()
+{
+    // 1 / n!, with a relative error below n 2^-53
+
+    std::array<double, 15> coefficients;
+    coefficients.at(0) = 1;
+
+    for (uint n = 1; n < coefficients.size(); ++n) {
+        coefficients.at(n) = coefficients.at(n - 1) / n;
+    }
+
+    return coefficients;
+}
+
+static const std::array<double, 15> dblexpcoefficients = dbl_expcoefficients();
+
+static inline double dbl_expapprox(double h)
+{
+    // exp(h) = 2^k exp(r) with r = h - k log(2), |r| < 0.35, for |h| <= dblexpmax; r has an absolute error below
+    // 2^-53 (the product k * dblln2hi and the first difference are exact), the Taylor polynomial of degree 14 has a
+    // truncation error below 2^-63 and the rounding errors in the coefficients and in Horner's scheme stay below
+    // 2^-48, so the relative error of the result is below 2^-47
+
+    const double k = std::nearbyint(h * 1.4426950408889634);
+    const double r = (h - k * dblln2hi) - k * dblln2lo;
+    double value = dblexpcoefficients.back();
+
+    for (uint n = dblexpcoefficients.size() - 1; n-- > 0;) {
+        value = value * r + dblexpcoefficients.at(n);
+    }
+
+    const uint64_t bits = uint64_t(int64_t(k) + 1023) << 52;
+    double scale = 0;
+    memcpy(&scale, &bits, sizeof(scale));
+    return value * scale;
+}
+
+static inline double dbl_expclamp(double h)
+{
+    return (h > -dblexpmax) ? ((h < dblexpmax) ? h : dblexpmax) : -dblexpmax;
+}
+
+static inline double dbl_explower(double h)
+{
+    // exp(h) >= exp(dblexpmax) for larger h, and 0 is a lower bound for smaller h
+
+    const double value = dbl_expapprox(dbl_expclamp(h));
+    return (h < -dblexpmax) ? 0.0 : dbl_down(value * (1 - dblexprelative));
+}
+
+static inline double dbl_expupper(double h)
+{
+    const double value = dbl_expapprox(dbl_expclamp(h));
+    return (h > dblexpmax) ? HUGE_VAL : dbl_up(value * (1 + dblexprelative));
+}
+
+static inline double dbl_logguess(double a)
+{
+    // log(a) up to about 2^-26 for a normal positive a: a = 2^e m with m in [sqrt(1/2), sqrt(2)], and
+    // log(m) = 2 atanh(s) with s = (m - 1) / (m + 1), |s| < 0.172, from the first five terms of its series
+
+    uint64_t bits = 0;
+    memcpy(&bits, &a, sizeof(bits));
+    const int64_t exponent = int64_t((bits >> 52) & 0x7ff) - 1023;
+    bits = (bits & ((uint64_t(1) << 52) - 1)) | (uint64_t(1023) << 52);
+    double m = 0;
+    memcpy(&m, &bits, sizeof(m));
+    const bool large = (m > 1.4142135623730951);
+    m = large ? (m / 2) : m;
+
+    const double s = (m - 1) / (m + 1);
+    const double s2 = s * s;
+    const double series = 2 * s * (1 + s2 * (1.0 / 3 + s2 * (1.0 / 5 + s2 * (1.0 / 7 + s2 * (1.0 / 9)))));
+    return double(exponent + (large ? 1 : 0)) * 0.6931471805599453 + series;
+}
+
+static inline double dbl_loglower(double a)
+{
+    // log(a) = y + log1p(t) with t = a exp(-y) - 1 for the guess y, and t - t^2 <= log1p(t) <= t for |t| <= 1/2;
+    // a exp(-y) is in [1/2, 2], so subtracting 1 is exact (a must be positive, finite and normal)
+
+    const double y = dbl_logguess(a);
+    const double t = dbl_down(a * dbl_explower(-y)) - 1;
+    return dbl_down(y + dbl_down(t - dbl_up(t * t)));
+}
+
+static inline double dbl_logupper(double a)
+{
+    const double y = dbl_logguess(a);
+    const double t = dbl_up(a * dbl_expupper(-y)) - 1;
+    return dbl_up(y + t);
+}
+
+// lower (upper) bounds of quotients and products with a positive factor given by its bounds [lower, upper]
+
+static inline double dbl_divlower(double a, double lower, double upper)
+{
+    return dbl_down(a / ((a >= 0) ? upper : lower));
+}
+
+static inline double dbl_divupper(double a, double lower, double upper)
+{
+    return dbl_up(a / ((a >= 0) ? lower : upper));
+}
+
+static inline double dbl_mullower(double a, double lower, double upper)
+{
+    return dbl_down(a * ((a >= 0) ? lower : upper));
+}
+
+static inline double dbl_mulupper(double a, double lower, double upper)
+{
+    return dbl_up(a * ((a >= 0) ? upper : lower));
+}
+
+#endif
@@ -0,0 +1,591 @@
+#ifndef DD_H
+#define DD_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <mpfr.h>
+#include <sys/types.h>
+
+#include "check.h"
+
+// double-double numbers hi + lo with |lo| <= ulp(hi) / 2, computed in the default rounding mode (to nearest) with the
+// algorithms of Joldes, Muller and Popescu, "Tight and rigorous error bounds for basic building blocks of double-word
+// arithmetic" (2017), whose relative errors are below 16u^2 with u = 2^-53
+
+struct dd_t {
+    double hi;
+    double lo;
+};
+
+// interval [left, right] of double-double numbers: every operation computes approximate endpoints and widens them
+// outward by a relative amount that exceeds the error bound of the operation
+
+struct ddi_t {
+    dd_t left;
+    dd_t right;
+};
+
+static const double ddrelative = std::ldexp(1.0, -98);    // arithmetic, > 16u^2 plus the error of the widening
+static const double ddexprelative = std::ldexp(1.0, -82); // exp and log, see dd_expapprox
+static const double ddtiny = std::ldexp(1.0, -900);       // below, lo might lose bits and the bounds above fail
+static const dd_t ddln2 = {0.6931471805599453094, 2.319046813846299558e-17};
+
+static inline dd_t dd_neg(const dd_t &a)
+{
+    return dd_t{-a.hi, -a.lo};
+}
+
+static inline dd_t dd_fasttwosum(double a, double b)
+{
+    // exact for |a| >= |b|
+
+    const double s = a + b;
+    return dd_t{s, b - (s - a)};
+}
+
+static inline dd_t dd_twosum(double a, double b)
+{
+    const double s = a + b;
+    const double t = s - a;
+    return dd_t{s, (a - (s - t)) + (b - t)};
+}
+
+static inline dd_t dd_twoprod(double a, double b)
+{
+    const double p = a * b;
+
+#ifdef __FMA__
+    return dd_t{p, std::fma(a, b, -p)};
+#else
+    // Veltkamp splitting into 26-bit halves, exact as long as nothing overflows
+
+    static const double splitter = 134217729.0; // 2^27 + 1
+    const double ca = splitter * a;
+    const double cb = splitter * b;
+    const double ahi = ca - (ca - a);
+    const double bhi = cb - (cb - b);
+    const double alo = a - ahi;
+    const double blo = b - bhi;
+    return dd_t{p, (((ahi * bhi - p) + ahi * blo) + alo * bhi) + alo * blo};
+#endif
+}
+
+static inline dd_t dd_add(const dd_t &a, const dd_t &b)
+{
+    // AccurateDWPlusDW, relative error <= 3u^2 even in case of cancellation
+
+    const dd_t s = dd_twosum(a.hi, b.hi);
+    const dd_t t = dd_twosum(a.lo, b.lo);
+    const dd_t v = dd_fasttwosum(s.hi, s.lo + t.hi);
+    return dd_fasttwosum(v.hi, t.lo + v.lo);
+}
+
+static inline dd_t dd_mul(const dd_t &a, const dd_t &b)
+{
+    // DWTimesDW1, relative error <= 7u^2
+
+    const dd_t c = dd_twoprod(a.hi, b.hi);
+    return dd_fasttwosum(c.hi, c.lo + (a.hi * b.lo + a.lo * b.hi));
+}
+
+static inline dd_t dd_mul_d(const dd_t &a, double b)
+{
+    // DWTimesFP1, relative error <= 2u^2
+
+    const dd_t c = dd_twoprod(a.hi, b);
+    const dd_t t = dd_fasttwosum(c.hi, a.lo * b);
+    return dd_fasttwosum(t.hi, t.lo + c.lo);
+}
+
+static inline dd_t dd_div(const dd_t &a, const dd_t &b)
+{
+    // DWDivDW2, relative error <= 15u^2 + 56u^3
+
+    const double th = a.hi / b.hi;
+    const dd_t r = dd_mul_d(b, th);
+    const dd_t p = dd_twosum(a.hi, -r.hi);
+    const double d = p.lo + (a.lo - r.lo);
+    return dd_fasttwosum(th, (p.hi + d) / b.hi);
+}
+
+static inline int dd_cmp(const dd_t &a, const dd_t &b)
+{
+    // the sign of a - b is exact because the relative error of the subtraction is below 1
+
+    if (!std::isfinite(a.hi) || !std::isfinite(b.hi)) {
+        return (a.hi < b.hi) ? -1 : ((a.hi > b.hi) ? 1 : 0);
+    }
+
+    const dd_t d = dd_add(a, dd_neg(b));
+    return (d.hi < 0) ? -1 : ((d.hi > 0) ? 1 : 0);
+}
+
+static inline bool dd_exactsum(const dd_t &a, const dd_t &b, const dd_t &sum)
+{
+    // a + b - sum as an expansion of nonoverlapping components (Shewchuk's Grow-Expansion, exact in round to nearest
+    // even), which vanishes if and only if all components vanish
+
+    std::array<double, 6> expansion = {{a.lo, a.hi, 0, 0, 0, 0}};
+    const std::array<double, 4> terms = {{b.lo, b.hi, -sum.lo, -sum.hi}};
+
+    for (uint i = 0; i < terms.size(); ++i) {
+        double carry = terms.at(i);
+
+        for (uint j = 0; j < 2 + i; ++j) {
+            const dd_t component = dd_twosum(carry, expansion.at(j));
+            expansion.at(j) = component.lo;
+            carry = component.hi;
+        }
+
+        expansion.at(2 + i) = carry;
+    }
+
+    return std::all_of(expansion.begin(), expansion.end(), [](double component) { return component == 0; });
+}
+
+static inline dd_t dd_widen(const dd_t &a, double relative, int direction)
+{
+    // move a by relative * |a| down (direction -1) or up (direction +1)
+
+    CHECK(std::isfinite(a.hi));
+    CHECK((a.hi == 0) || (std::fabs(a.hi) > ddtiny));
+    return dd_add(a, dd_t{direction * relative * std::fabs(a.hi), 0});
+}
+
+static inline dd_t dd_ldexp(const dd_t &a, int exponent)
+{
+    const dd_t result = {std::ldexp(a.hi, exponent), std::ldexp(a.lo, exponent)};
+    CHECK((result.hi == 0) || (std::fabs(result.hi) > ddtiny));
+    return result;
+}
+
+static std::array<dd_t, 11> dd_expcoefficients()
+{
+    // 1 / n!, n! is exact for n <= 18
+
+    std::array<dd_t, 11> coefficients;
+    double factorial = 1;
+
+    for (uint n = 0; n < coefficients.size(); ++n) {
+        factorial *= std::max(1u, n);
+        coefficients.at(n) = dd_div(dd_t{1, 0}, dd_t{factorial, 0});
+    }
+
+    return coefficients;
+}
+
+static const std::array<dd_t, 11> ddexpcoefficients = dd_expcoefficients();
+
+static inline dd_t dd_expapprox(double h)
+{
+    // exp(h) = 2^k exp(s)^256 with s = (h - k log(2)) / 256, |s| < 0.35 / 256, and exp(s) from its Taylor polynomial of
+    // degree 10 (truncation error < 2^-128); the rounding errors stay below 2^-99 in the polynomial, are amplified by
+    // at most 2^8 in the squarings and add at most 2^-93 from the reduction (|k| <= 866), so the relative error of
+    // the result is below 2^-86
+
+    CHECK(std::fabs(h) < 600);
+    const double k = std::nearbyint(h / ddln2.hi);
+    const dd_t r = dd_add(dd_t{h, 0}, dd_neg(dd_mul_d(ddln2, k)));
+    CHECK(std::fabs(r.hi) < 0.35);
+
+    const dd_t s = {std::ldexp(r.hi, -8), std::ldexp(r.lo, -8)};
+    dd_t value = ddexpcoefficients.back();
+
+    for (uint n = ddexpcoefficients.size() - 1; n-- > 0;) {
+        value = dd_add(dd_mul(value, s), ddexpcoefficients.at(n));
+    }
+
+    for (uint i = 0; i < 8; ++i) {
+        value = dd_mul(value, value);
+    }
+
+    return dd_ldexp(value, int(k));
+}
+
+static inline dd_t dd_expsmall(double l)
+{
+    // 1 + l + l^2 / 2 = exp(l) up to a relative error of |l|^3 / 5 < 2^-130
+
+    CHECK(std::fabs(l) < std::ldexp(1.0, -43));
+    return dd_add(dd_twosum(1, l), dd_t{l * l / 2, 0});
+}
+
+static inline dd_t dd_log(const dd_t &a, double y, const dd_t &base, int direction)
+{
+    // log(a) = y + log1p(t) with t = a exp(-y) - 1, base ~ exp(-y) and y ~ log(a.hi); for |t| < 2^-40, the error of
+    // log1p(t) ~ t - t^2 / 2 (including rounding t^2 / 2) is below 2^-118, and log1p is increasing
+
+    const dd_t scaled = dd_widen(dd_mul(a, dd_widen(base, ddexprelative, direction)), ddrelative, direction);
+    const dd_t t = dd_widen(dd_add(scaled, dd_t{-1, 0}), ddrelative, direction);
+    CHECK(std::fabs(t.hi) < std::ldexp(1.0, -40));
+
+    const dd_t series = dd_add(dd_add(t, dd_t{-t.hi * t.hi / 2, 0}), dd_t{direction * std::ldexp(1.0, -118), 0});
+    return dd_widen(dd_add(dd_t{y, 0}, series), ddrelative, direction);
+}
+
+// interval operations with the semantics of the corresponding MPFI functions, the result may alias the arguments
+
+static inline void ddi_set_si(ddi_t &result, long value)
+{
+    CHECK(std::labs(value) < (1L << 53));
+    result.left = dd_t{double(value), 0};
+    result.right = result.left;
+}
+
+static inline void ddi_set_ui_2exp(ddi_t &result, uint64_t value, int exponent)
+{
+    // value * 2^exponent, split exactly into a rounded double and the remainder
+
+    CHECK((value >> 63) == 0);
+    const double hi = double(value);
+    const double lo = double(int64_t(value - uint64_t(hi)));
+    result.left = dd_ldexp(dd_fasttwosum(hi, lo), exponent);
+    result.right = result.left;
+}
+
+static inline void ddi_set_str(ddi_t &result, const char *string)
+{
+    // the constants of the verification are dyadic and need to be exactly representable
+
+    mpfr_t value;
+    mpfr_init2(value, 128);
+    CHECK(mpfr_strtofr(value, string, nullptr, 0, MPFR_RNDN) == 0);
+    const double hi = mpfr_get_d(value, MPFR_RNDN);
+    CHECK(mpfr_sub_d(value, value, hi, MPFR_RNDN) == 0);
+    const double lo = mpfr_get_d(value, MPFR_RNDN);
+    CHECK(mpfr_cmp_d(value, lo) == 0);
+    mpfr_clear(value);
+
+    result.left = dd_fasttwosum(hi, lo);
+    CHECK((result.left.hi == hi) && (result.left.lo == lo));
+    result.right = result.left;
+}
+
+static inline void ddi_div_2si(ddi_t &result, const ddi_t &a, int exponent)
+{
+    result.left = dd_ldexp(a.left, -exponent);
+    result.right = dd_ldexp(a.right, -exponent);
+}
+
+static inline void ddi_neg(ddi_t &result, const ddi_t &a)
+{
+    const dd_t left = dd_neg(a.right);
+    result.right = dd_neg(a.left);
+    result.left = left;
+}
+
+static inline void ddi_add(ddi_t &result, const ddi_t &a, const ddi_t &b)
+{
+    result.left = dd_widen(dd_add(a.left, b.left), ddrelative, -1);
+    result.right = dd_widen(dd_add(a.right, b.right), ddrelative, 1);
+}
+
+static inline void ddi_add_exact(ddi_t &result, const ddi_t &a, const ddi_t &b)
+{
+    // like ddi_add, but endpoints that are exact (such as sums of dyadic constants) are not widened
+
+    const dd_t left = dd_add(a.left, b.left);
+    const dd_t right = dd_add(a.right, b.right);
+    result.left = dd_exactsum(a.left, b.left, left) ? left : dd_widen(left, ddrelative, -1);
+    result.right = dd_exactsum(a.right, b.right, right) ? right : dd_widen(right, ddrelative, 1);
+}
+
+static inline void ddi_sub_exact(ddi_t &result, const ddi_t &a, const ddi_t &b)
+{
+    ddi_t negated;
+    ddi_neg(negated, b);
+    ddi_add_exact(result, a, negated);
+}
+
+static inline void ddi_sub(ddi_t &result, const ddi_t &a, const ddi_t &b)
+{
+    const dd_t left = dd_widen(dd_add(a.left, dd_neg(b.right)), ddrelative, -1);
+    result.right = dd_widen(dd_add(a.right, dd_neg(b.left)), ddrelative, 1);
+    result.left = left;
+}
+
+static inline void ddi_si_sub(ddi_t &result, long value, const ddi_t &a)
+{
+    ddi_t b;
+    ddi_set_si(b, value);
+    ddi_sub(result, b, a);
+}
+
+static inline void ddi_mul(ddi_t &result, const ddi_t &a, const ddi_t &b)
+{
+    // nonnegative factors need two products, otherwise all four endpoint products are compared
+
+    if ((a.left.hi >= 0) && (b.left.hi >= 0)) {
+        result.left = dd_widen(dd_mul(a.left, b.left), ddrelative, -1);
+        result.right = dd_widen(dd_mul(a.right, b.right), ddrelative, 1);
+        return;
+    }
+
+    const std::array<dd_t, 4> products = {{dd_mul(a.left, b.left), dd_mul(a.left, b.right), dd_mul(a.right, b.left), dd_mul(a.right, b.right)}};
+    result.left = products.at(0);
+    result.right = products.at(0);
+
+    for (const dd_t &product : products) {
+        result.left = (dd_cmp(product, result.left) < 0) ? product : result.left;
+        result.right = (dd_cmp(product, result.right) > 0) ? product : result.right;
+    }
+
+    result.left = dd_widen(result.left, ddrelative, -1);
+    result.right = dd_widen(result.right, ddrelative, 1);
+}
+
+static inline void ddi_div(ddi_t &result, const ddi_t &a, const ddi_t &b)
+{
+    CHECK((b.left.hi > 0) || (b.right.hi < 0));
+
+    if ((a.left.hi >= 0) && (b.left.hi > 0)) {
+        const dd_t left = dd_widen(dd_div(a.left, b.right), ddrelative, -1);
+        result.right = dd_widen(dd_div(a.right, b.left), ddrelative, 1);
+        result.left = left;
+        return;
+    }
+
+    const std::array<dd_t, 4> quotients = {{dd_div(a.left, b.left), dd_div(a.left, b.right), dd_div(a.right, b.left), dd_div(a.right, b.right)}};
+    result.left = quotients.at(0);
+    result.right = quotients.at(0);
+
+    for (const dd_t &quotient : quotients) {
+        result.left = (dd_cmp(quotient, result.left) < 0) ? quotient : result.left;
+        result.right = (dd_cmp(quotient, result.right) > 0) ? quotient : result.right;
+    }
+
+    result.left = dd_widen(result.left, ddrelative, -1);
+    result.right = dd_widen(result.right, ddrelative, 1);
+}
+
+static inline void ddi_div_si(ddi_t &result, const ddi_t &a, long value)
+{
+    ddi_t b;
+    ddi_set_si(b, value);
+    ddi_div(result, a, b);
+}
+
+static inline void ddi_exp(ddi_t &result, const ddi_t &a)
+{
+    // exp is increasing, and both endpoints share the expensive exp(hi) when their leading parts agree
+
+    const dd_t leftbase = dd_expapprox(a.left.hi);
+    const dd_t rightbase = (a.right.hi == a.left.hi) ? leftbase : dd_expapprox(a.right.hi);
+    result.left = dd_widen(dd_mul(leftbase, dd_expsmall(a.left.lo)), ddexprelative, -1);
+    result.right = dd_widen(dd_mul(rightbase, dd_expsmall(a.right.lo)), ddexprelative, 1);
+}
+
+static inline void ddi_log(ddi_t &result, const ddi_t &a)
+{
+    // log is increasing, and both endpoints share exp(-y) when their leading parts agree
+
+    CHECK(a.left.hi > 0);
+    const double lefty = std::log(a.left.hi);
+    const double righty = (a.right.hi == a.left.hi) ? lefty : std::log(a.right.hi);
+    const dd_t leftbase = dd_expapprox(-lefty);
+    const dd_t rightbase = (righty == lefty) ? leftbase : dd_expapprox(-righty);
+    result.left = dd_log(a.left, lefty, leftbase, -1);
+    result.right = dd_log(a.right, righty, rightbase, 1);
+}
+
+static inline bool ddi_bounded_p(const ddi_t &a)
+{
+    return std::isfinite(a.left.hi) && std::isfinite(a.right.hi);
+}
+
+static inline int ddi_cmp(const ddi_t &a, const ddi_t &b)
+{
+    return (dd_cmp(a.right, b.left) < 0) ? -1 : ((dd_cmp(a.left, b.right) > 0) ? 1 : 0);
+}
+
+static inline int ddi_cmp_d(const ddi_t &a, double value)
+{
+    const ddi_t b = {{value, 0}, {value, 0}};
+    return ddi_cmp(a, b);
+}
+
+static inline int ddi_cmp_si(const ddi_t &a, long value)
+{
+    ddi_t b;
+    ddi_set_si(b, value);
+    return ddi_cmp(a, b);
+}
+
+// fixed-point numbers with ddfixedshift fraction bits, enough for the smallest subnormal, in 32-bit words with the
+// least significant first; there is room for an integer part below 2^62 times 10^ddfixeddigits
+
+static const uint ddfixedshift = 1074;
+static const int ddfixeddigits = 40;
+typedef std::array<uint32_t, 40> ddfixed_t;
+
+static inline void dd_fixedadd(ddfixed_t &words, double value, bool subtract)
+{
+    // value = mantissa * 2^exponent with exponent >= -ddfixedshift, which is exact also for subnormals
+
+    int exponent = 0;
+    uint64_t mantissa = uint64_t(std::ldexp(std::frexp(value, &exponent), 53));
+    exponent -= 53;
+
+    for (; exponent < -int(ddfixedshift); ++exponent) {
+        mantissa >>= 1;
+    }
+
+    const uint shift = uint(exponent + int(ddfixedshift));
+    const uint64_t low = mantissa << (shift % 32);
+    const uint64_t high = (shift % 32 != 0) ? (mantissa >> (64 - shift % 32)) : 0;
+    const std::array<uint64_t, 3> parts = {low & UINT32_MAX, low >> 32, high};
+    uint64_t carry = 0;
+
+    for (uint index = shift / 32; (index < words.size()) && ((index < shift / 32 + 3) || (carry != 0)); ++index) {
+        const uint64_t part = (index < shift / 32 + 3) ? parts.at(index - shift / 32) : 0;
+
+        if (subtract) {
+            const uint64_t difference = uint64_t(words.at(index)) - part - carry;
+            words.at(index) = uint32_t(difference);
+            carry = (difference >> 32) & 1;
+        } else {
+            const uint64_t sum = uint64_t(words.at(index)) + part + carry;
+            words.at(index) = uint32_t(sum);
+            carry = sum >> 32;
+        }
+    }
+
+    CHECK(carry == 0);
+}
+
+// "%.<digits>RDf" and "%.<digits>RUf" of mpfr_snprintf for the exact value of hi + lo, computed on the stack, so that
+// printing the value of a leaf does not allocate; returns -1 for other formats and for values that are too large
+
+static inline int dd_snprintffixed(char *buffer, size_t size, const char *format, const dd_t &a)
+{
+    if ((format[0] != '%') || (format[1] != '.')) {
+        return -1;
+    }
+
+    int digits = 0;
+    const char *next = format + 2;
+
+    for (; (*next >= '0') && (*next <= '9') && (digits <= ddfixeddigits); ++next) {
+        digits = 10 * digits + (*next - '0');
+    }
+
+    if ((next == format + 2) || (digits > ddfixeddigits) || (next[0] != 'R') || ((next[1] != 'D') && (next[1] != 'U')) || (next[2] != 'f') || (next[3] != '\0')) {
+        return -1;
+    }
+
+    if (!std::isfinite(a.hi) || !std::isfinite(a.lo) || (std::fabs(a.hi) >= std::ldexp(1.0, 61))) {
+        return -1;
+    }
+
+    // |hi + lo| is |hi| +- |lo|, or |lo| if hi is zero, as |lo| <= ulp(hi) / 2
+
+    const double first = (a.hi != 0) ? a.hi : a.lo;
+    const double second = (a.hi != 0) ? a.lo : 0.0;
+    const bool negative = first < 0;
+    ddfixed_t words = {};
+
+    if (first != 0) {
+        dd_fixedadd(words, std::fabs(first), false);
+    }
+
+    if (second != 0) {
+        dd_fixedadd(words, std::fabs(second), (second < 0) != negative);
+    }
+
+    for (int digit = 0; digit < digits; ++digit) {
+        uint64_t carry = 0;
+
+        for (uint32_t &word : words) {
+            const uint64_t product = uint64_t(word) * 10 + carry;
+            word = uint32_t(product);
+            carry = product >> 32;
+        }
+
+        CHECK(carry == 0);
+    }
+
+    // the integer part, whose magnitude is rounded up if the value is rounded away from zero and bits are cut off
+
+    bool inexact = (words.at(ddfixedshift / 32) & ((UINT32_C(1) << (ddfixedshift % 32)) - 1)) != 0;
+    std::array<uint32_t, words.size() - ddfixedshift / 32> integer = {};
+
+    for (uint index = 0; index < ddfixedshift / 32; ++index) {
+        inexact = inexact || (words.at(index) != 0);
+    }
+
+    for (uint index = 0; index < integer.size(); ++index) {
+        const uint64_t high = (index + 1 < integer.size()) ? words.at(ddfixedshift / 32 + index + 1) : 0;
+        integer.at(index) = uint32_t(((high << 32) | words.at(ddfixedshift / 32 + index)) >> (ddfixedshift % 32));
+    }
+
+    if (inexact && ((next[1] == 'U') != negative)) {
+        for (uint index = 0; (index < integer.size()) && (++integer.at(index) == 0); ++index) {
+        }
+    }
+
+    // the decimal digits from the last one, with at least one before the point
+
+    std::array<char, 64 + ddfixeddigits> reversed;
+    size_t count = 0;
+    bool zero = false;
+
+    while (!zero || (count <= size_t(digits))) {
+        uint64_t remainder = 0;
+        zero = true;
+
+        for (uint index = integer.size(); index-- > 0;) {
+            const uint64_t dividend = (remainder << 32) | integer.at(index);
+            integer.at(index) = uint32_t(dividend / 10);
+            remainder = dividend % 10;
+            zero = zero && (integer.at(index) == 0);
+        }
+
+        reversed.at(count++) = char('0' + remainder);
+    }
+
+    std::array<char, 66 + ddfixeddigits> text;
+    size_t length = 0;
+
+    if (negative) {
+        text.at(length++) = '-';
+    }
+
+    for (; count > 0; --count) {
+        if ((count == size_t(digits)) && (digits > 0)) {
+            text.at(length++) = '.';
+        }
+
+        text.at(length++) = reversed.at(count - 1);
+    }
+
+    if (size > 0) {
+        const size_t copied = std::min(length, size - 1);
+        std::copy(text.begin(), text.begin() + copied, buffer);
+        buffer[copied] = '\0';
+    }
+
+    return int(length);
+}
+
+static inline int dd_snprintf(char *buffer, size_t size, const char *format, const dd_t &a)
+{
+    const int length = dd_snprintffixed(buffer, size, format, a);
+
+    if (length >= 0) {
+        return length;
+    }
+
+    // otherwise, the exact value of hi + lo is handed to mpfr_snprintf, so that the format decides about the rounding
+
+    std::array<mp_limb_t, (2200 + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS> limbs;
+    mpfr_t value;
+    mpfr_custom_init(limbs.data(), 2200);
+    mpfr_custom_init_set(value, MPFR_NAN_KIND, 0, 2200, limbs.data());
+    CHECK(mpfr_set_d(value, a.hi, MPFR_RNDN) == 0);
+    CHECK(mpfr_add_d(value, value, a.lo, MPFR_RNDN) == 0);
+    return mpfr_snprintf(buffer, size, format, value);
+}
+
+#endif
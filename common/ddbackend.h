@@ -0,0 +1,92 @@
+#ifndef DDBACKEND_H
+#define DDBACKEND_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "backend.h"
+#include "dd.h"
+#include "mpfrbackend.h"
+
+// double-double intervals: the rounding directions are not needed, except that exact operations are not widened
+
+struct DdBackend {
+    using number_t = ddi_t;
+
+    static void set(number_t &result, const number_t &a) { result = a; }
+    static void setsi(number_t &result, long value) { ddi_set_si(result, value); }
+    static void setstr(number_t &result, const char *string) { ddi_set_str(result, string); }
+    static void setui2exp(number_t &result, uint64_t value, int exponent) { ddi_set_ui_2exp(result, value, exponent); }
+    static void setzero(number_t &result) { ddi_set_si(result, 0); }
+    static void setinf(number_t &result) { result = ddi_t{{HUGE_VAL, 0}, {HUGE_VAL, 0}}; }
+
+    static void add(number_t &result, const number_t &a, const number_t &b, rounding_t rounding)
+    {
+        if (rounding == exact) {
+            ddi_add_exact(result, a, b);
+        } else {
+            ddi_add(result, a, b);
+        }
+    }
+
+    static void sub(number_t &result, const number_t &a, const number_t &b, rounding_t rounding)
+    {
+        if (rounding == exact) {
+            ddi_sub_exact(result, a, b);
+        } else {
+            ddi_sub(result, a, b);
+        }
+    }
+
+    static void sisub(number_t &result, long a, const number_t &b, rounding_t rounding)
+    {
+        number_t value;
+        ddi_set_si(value, a);
+        sub(result, value, b, rounding);
+    }
+
+    static void mul(number_t &result, const number_t &a, const number_t &b, rounding_t) { ddi_mul(result, a, b); }
+    static void div(number_t &result, const number_t &a, const number_t &b, rounding_t) { ddi_div(result, a, b); }
+    static void divsi(number_t &result, const number_t &a, long b, rounding_t) { ddi_div_si(result, a, b); }
+    static void div2si(number_t &result, const number_t &a, long exponent) { ddi_div_2si(result, a, int(exponent)); }
+    static void neg(number_t &result, const number_t &a) { ddi_neg(result, a); }
+    static void log(number_t &result, const number_t &a, rounding_t) { ddi_log(result, a); }
+    static void exp(number_t &result, const number_t &a, rounding_t) { ddi_exp(result, a); }
+
+    static void min(number_t &result, const number_t &a)
+    {
+        result.left = (dd_cmp(a.left, result.left) < 0) ? a.left : result.left;
+        result.right = (dd_cmp(a.right, result.right) < 0) ? a.right : result.right;
+    }
+
+    static int cmp(const number_t &a, const number_t &b) { return ddi_cmp(a, b); }
+    static int cmpsi(const number_t &a, long b) { return ddi_cmp_si(a, b); }
+    static int cmpd(const number_t &a, double b) { return ddi_cmp_d(a, b); }
+    static bool bounded(const number_t &a) { return ddi_bounded_p(a); }
+    static bool iszero(const number_t &a) { return (a.left.hi == 0) && (a.right.hi == 0); }
+
+    static bool regular(const number_t &a)
+    {
+        // nonzero, finite and not a single point
+        return ddi_bounded_p(a) && (a.left.hi != 0) && (a.right.hi != 0) && (dd_cmp(a.left, a.right) < 0);
+    }
+
+    static int snprintf(char *buffer, size_t size, const char *format, const number_t &a, rounding_t rounding)
+    {
+        return dd_snprintf(buffer, size, format, (rounding == up) ? a.right : a.left);
+    }
+
+    static void get2exp(int64_t &mantissa, int64_t &exponent, const number_t &a, rounding_t rounding)
+    {
+        // the exact value of hi + lo, as in dd_snprintf
+
+        const dd_t &end = (rounding == up) ? a.right : a.left;
+        Mympfr<2200> value;
+        CHECK(mpfr_set_d(value, end.hi, MPFR_RNDN) == 0);
+        CHECK(mpfr_add_d(value, value, end.lo, MPFR_RNDN) == 0);
+        mpfr_get_2exp63(mantissa, exponent, value, (rounding == up) ? MPFR_RNDU : MPFR_RNDD);
+    }
+};
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef MPFIBACKEND_H
+#define MPFIBACKEND_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mpfi.h>
+
+#include "backend.h"
+#include "mpfrbackend.h"
+
+// both endpoints keep their limbs in the object, as in Mympfr
+
+template <int precision>
+class Mympfi
+{
+  public:
+    static_assert((precision >= MPFR_PREC_MIN) && (precision <= MPFR_PREC_MAX), "");
+
+    Mympfi()
+    {
+        mpfr_custom_init(leftlimbs.data(), precision);
+        mpfr_custom_init(rightlimbs.data(), precision);
+        mpfr_custom_init_set(&value->left, MPFR_NAN_KIND, 0, precision, leftlimbs.data());
+        mpfr_custom_init_set(&value->right, MPFR_NAN_KIND, 0, precision, rightlimbs.data());
+    }
+
+    operator mpfi_ptr() { return value; }
+    operator mpfi_srcptr() const { return value; }
+    mpfi_ptr operator->() { return value; }
+    mpfi_srcptr operator->() const { return value; }
+
+  private:
+    Mympfi(const Mympfi &) = delete;
+    Mympfi &operator=(const Mympfi &) = delete;
+
+    mpfrlimbs_t<precision> leftlimbs;
+    mpfrlimbs_t<precision> rightlimbs;
+    mpfi_t value;
+};
+
+// MPFI intervals: the rounding directions are not needed
+
+template <int precision>
+struct MpfiBackend {
+    using number_t = Mympfi<precision>;
+
+    static void set(number_t &result, const number_t &a) { mpfi_set(result, a); }
+    static void setsi(number_t &result, long value) { mpfi_set_si(result, value); }
+    static void setstr(number_t &result, const char *string) { mpfi_set_str(result, string, 0); }
+    static void setzero(number_t &result) { mpfi_set_si(result, 0); }
+
+    static void setui2exp(number_t &result, uint64_t value, int exponent)
+    {
+        mpfr_set_ui_2exp(&result->left, value, exponent, MPFR_RNDD);
+        mpfr_set_ui_2exp(&result->right, value, exponent, MPFR_RNDU);
+    }
+
+    static void setinf(number_t &result)
+    {
+        // [+\infty,+\infty] is not a valid interval, but a valid start for min
+        mpfr_set_inf(&result->left, 0);
+        mpfr_set_inf(&result->right, 0);
+    }
+
+    static void add(number_t &result, const number_t &a, const number_t &b, rounding_t) { mpfi_add(result, a, b); }
+    static void sub(number_t &result, const number_t &a, const number_t &b, rounding_t) { mpfi_sub(result, a, b); }
+    static void sisub(number_t &result, long a, const number_t &b, rounding_t) { mpfi_si_sub(result, a, b); }
+    static void mul(number_t &result, const number_t &a, const number_t &b, rounding_t) { mpfi_mul(result, a, b); }
+    static void div(number_t &result, const number_t &a, const number_t &b, rounding_t) { mpfi_div(result, a, b); }
+    static void divsi(number_t &result, const number_t &a, long b, rounding_t) { mpfi_div_si(result, a, b); }
+    static void div2si(number_t &result, const number_t &a, long exponent) { mpfi_div_2si(result, a, exponent); }
+    static void neg(number_t &result, const number_t &a) { mpfi_neg(result, a); }
+    static void log(number_t &result, const number_t &a, rounding_t) { mpfi_log(result, a); }
+    static void exp(number_t &result, const number_t &a, rounding_t) { mpfi_exp(result, a); }
+
+    static void min(number_t &result, const number_t &a)
+    {
+        CHECK(mpfr_min(&result->left, &result->left, &a->left, MPFR_RNDN) == 0);
+        CHECK(mpfr_min(&result->right, &result->right, &a->right, MPFR_RNDN) == 0);
+    }
+
+    static int cmp(const number_t &a, const number_t &b) { return mpfi_cmp(a, b); }
+    static int cmpsi(const number_t &a, long b) { return mpfi_cmp_si(a, b); }
+    static int cmpd(const number_t &a, double b) { return mpfi_cmp_d(a, b); }
+    static bool bounded(const number_t &a) { return mpfi_bounded_p(a) != 0; }
+    static bool iszero(const number_t &a) { return mpfi_is_zero(a) != 0; }
+
+    static bool regular(const number_t &a)
+    {
+        // nonzero, finite and not a single point
+        return (mpfr_regular_p(&a->left) != 0) && (mpfr_regular_p(&a->right) != 0) && (mpfr_cmp(&a->left, &a->right) < 0);
+    }
+
+    static int snprintf(char *buffer, size_t size, const char *format, const number_t &a, rounding_t rounding)
+    {
+        return mpfr_snprintf(buffer, size, format, (rounding == up) ? &a->right : &a->left);
+    }
+
+    static void get2exp(int64_t &mantissa, int64_t &exponent, const number_t &a, rounding_t rounding)
+    {
+        mpfr_get_2exp63(mantissa, exponent, (rounding == up) ? &a->right : &a->left, (rounding == up) ? MPFR_RNDU : MPFR_RNDD);
+    }
+};
+
+#endif
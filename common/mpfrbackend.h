@@ -0,0 +1,120 @@
+#ifndef MPFRBACKEND_H
+#define MPFRBACKEND_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mpfr.h>
+
+#include "backend.h"
+
+// the limbs of a number with a given precision, so that a number can keep them in place (MPFR's custom interface)
+// instead of allocating them
+
+template <int precision>
+using mpfrlimbs_t = std::array<mp_limb_t, (precision + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS>;
+
+// a number holds its own limbs, so creating one does not allocate, and it cannot be copied or moved since the mpfr_t
+// points into it
+
+template <int precision>
+class Mympfr
+{
+  public:
+    static_assert((precision >= MPFR_PREC_MIN) && (precision <= MPFR_PREC_MAX), "");
+
+    Mympfr()
+    {
+        mpfr_custom_init(limbs.data(), precision);
+        mpfr_custom_init_set(value, MPFR_NAN_KIND, 0, precision, limbs.data());
+    }
+
+    operator mpfr_ptr() { return value; }
+    operator mpfr_srcptr() const { return value; }
+
+  private:
+    Mympfr(const Mympfr &) = delete;
+    Mympfr &operator=(const Mympfr &) = delete;
+
+    mpfrlimbs_t<precision> limbs;
+    mpfr_t value;
+};
+
+// a value rounded to 63 bits as mantissa * 2^exponent (see backend.h)
+
+static inline void mpfr_get_2exp63(int64_t &mantissa, int64_t &exponent, mpfr_srcptr a, mpfr_rnd_t rounding)
+{
+    Mympfr<63> value;
+    CHECK(mpfr_number_p(a) != 0);
+    mpfr_set(value, a, rounding);
+    mantissa = 0;
+    exponent = 0;
+
+    if (mpfr_zero_p(value) == 0) {
+        exponent = mpfr_get_exp(value) - 63;
+        CHECK(mpfr_mul_2si(value, value, -exponent, MPFR_RNDN) == 0);
+
+        // the integer in two parts that are exact as doubles, since mpfr_get_si allocates a temporary
+
+        const double high = mpfr_get_d(value, MPFR_RNDZ);
+        CHECK(mpfr_sub_d(value, value, high, MPFR_RNDN) == 0);
+        mantissa = int64_t(high) + int64_t(mpfr_get_d(value, MPFR_RNDN));
+    }
+}
+
+// the constants that MPFR caches per thread (log 2 for exp, log 2 and pi for log) at a precision above any that the
+// verifiers need, so that their caches are not reallocated in the middle of a leaf (see arena.h)
+
+static inline void mpfr_fillcaches()
+{
+    Mympfr<4096> value;
+    mpfr_const_log2(value, MPFR_RNDN);
+    mpfr_const_pi(value, MPFR_RNDN);
+}
+
+// MPFR with directed rounding: every operation rounds in the direction in which its value is needed, and exact
+// operations check that they are exact
+
+template <int precision>
+struct MpfrBackend {
+    using number_t = Mympfr<precision>;
+
+    static void set(number_t &result, const number_t &a) { CHECK(mpfr_set(result, a, MPFR_RNDN) == 0); }
+    static void setsi(number_t &result, long value) { CHECK(mpfr_set_si(result, value, MPFR_RNDN) == 0); }
+    static void setstr(number_t &result, const char *string) { CHECK(mpfr_strtofr(result, string, nullptr, 0, MPFR_RNDN) == 0); }
+    static void setui2exp(number_t &result, uint64_t value, int exponent) { CHECK(mpfr_set_ui_2exp(result, value, exponent, MPFR_RNDN) == 0); }
+    static void setzero(number_t &result) { mpfr_set_zero(result, 0); }
+    static void setinf(number_t &result) { mpfr_set_inf(result, 0); }
+
+    static void add(number_t &result, const number_t &a, const number_t &b, rounding_t rounding) { rounded(mpfr_add(result, a, b, mode(rounding)), rounding); }
+    static void sub(number_t &result, const number_t &a, const number_t &b, rounding_t rounding) { rounded(mpfr_sub(result, a, b, mode(rounding)), rounding); }
+    static void sisub(number_t &result, long a, const number_t &b, rounding_t rounding) { rounded(mpfr_si_sub(result, a, b, mode(rounding)), rounding); }
+    static void mul(number_t &result, const number_t &a, const number_t &b, rounding_t rounding) { rounded(mpfr_mul(result, a, b, mode(rounding)), rounding); }
+    static void div(number_t &result, const number_t &a, const number_t &b, rounding_t rounding) { rounded(mpfr_div(result, a, b, mode(rounding)), rounding); }
+    static void divsi(number_t &result, const number_t &a, long b, rounding_t rounding) { rounded(mpfr_div_si(result, a, b, mode(rounding)), rounding); }
+    static void div2si(number_t &result, const number_t &a, long exponent) { CHECK(mpfr_div_2si(result, a, exponent, MPFR_RNDN) == 0); }
+    static void neg(number_t &result, const number_t &a) { CHECK(mpfr_neg(result, a, MPFR_RNDN) == 0); }
+    static void log(number_t &result, const number_t &a, rounding_t rounding) { rounded(mpfr_log(result, a, mode(rounding)), rounding); }
+    static void exp(number_t &result, const number_t &a, rounding_t rounding) { rounded(mpfr_exp(result, a, mode(rounding)), rounding); }
+    static void min(number_t &result, const number_t &a) { CHECK(mpfr_min(result, result, a, MPFR_RNDN) == 0); }
+
+    static int cmp(const number_t &a, const number_t &b) { return mpfr_cmp(a, b); }
+    static int cmpsi(const number_t &a, long b) { return mpfr_cmp_si(a, b); }
+    static int cmpd(const number_t &a, double b) { return mpfr_cmp_d(a, b); }
+    static bool bounded(const number_t &a) { return mpfr_number_p(a) != 0; }
+    static bool regular(const number_t &a) { return mpfr_regular_p(a) != 0; }
+    static bool iszero(const number_t &a) { return mpfr_zero_p(a) != 0; }
+
+    static int snprintf(char *buffer, size_t size, const char *format, const number_t &a, rounding_t)
+    {
+        return mpfr_snprintf(buffer, size, format, static_cast<mpfr_srcptr>(a));
+    }
+
+    static void get2exp(int64_t &mantissa, int64_t &exponent, const number_t &a, rounding_t rounding) { mpfr_get_2exp63(mantissa, exponent, a, mode(rounding)); }
+
+  private:
+    static mpfr_rnd_t mode(rounding_t rounding) { return (rounding == down) ? MPFR_RNDD : ((rounding == up) ? MPFR_RNDU : MPFR_RNDN); }
+    static void rounded(int ternary, rounding_t rounding) { CHECK((rounding != exact) || (ternary == 0)); }
+};
+
+#endif
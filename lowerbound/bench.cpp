@@ -0,0 +1,269 @@
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <random>
+
+#include "../common/ddbackend.h"
+#include "../common/mpfibackend.h"
+#include "../common/mpfrbackend.h"
+#include "verifier.h"
+
+// benchmark of Verifier::verify for every backend and several precisions, on synthetic leaves (random boxes at a
+// shallow and a deep level of the split tree) and on runs of consecutive leaves sampled from a certificate, and of
+// the traversal of the certificate on its own
+
+static const double benchseconds = 0.5;
+static const size_t syntheticleafs = 1024;
+static const size_t samplerun = 64;
+static const size_t sampleleafs = 4096;
+
+// heap allocations, counted by the global operator new and by the memory functions of GMP, which MPFR uses
+
+static uint64_t allocations = 0;
+static void *(*gmpallocate)(size_t);
+static void *(*gmpreallocate)(void *, size_t, size_t);
+static void (*gmpfree)(void *, size_t);
+
+void *operator new(size_t size)
+{
+    ++allocations;
+    void *pointer = malloc((size != 0) ? size : 1);
+
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return pointer;
+}
+
+void operator delete(void *pointer) noexcept
+{
+    free(pointer);
+}
+
+static void *countedallocate(size_t size)
+{
+    ++allocations;
+    return gmpallocate(size);
+}
+
+static void *countedreallocate(void *pointer, size_t oldsize, size_t size)
+{
+    ++allocations;
+    return gmpreallocate(pointer, oldsize, size);
+}
+
+static void countallocations()
+{
+    mp_get_memory_functions(&gmpallocate, &gmpreallocate, &gmpfree);
+    mp_set_memory_functions(countedallocate, countedreallocate, gmpfree);
+}
+
+struct benchleaf_t {
+    qxybounds_t qxybounds;
+    leaf_t leaf;
+};
+
+// random descent from the root: at every level, one of the splits that leaves both parts valid is chosen
+
+static std::vector<benchleaf_t> synthetic(uint depth, uint64_t seed)
+{
+    std::mt19937_64 random(seed);
+    std::vector<benchleaf_t> leafs(syntheticleafs);
+
+    for (benchleaf_t &leaf : leafs) {
+        qxybounds_t qxybounds = rootqxybounds;
+        tighten(qxybounds);
+
+        // a box that contains a point mass gives D exactly and thus fails the check on D, so such boxes are drawn again
+
+        for (uint level = 0; (level < depth) || (*std::max_element(qxybounds.upper.begin(), qxybounds.upper.end()) == fixedpointone); ++level) {
+            qxybounds_t lower;
+            qxybounds_t upper;
+            uint attempt = 0;
+
+            for (; attempt < 32; ++attempt) {
+                const uint j = uint(random() % 6);
+
+                if (((qxybounds.lower.at(j) % 2) != 0) || ((qxybounds.upper.at(j) % 2) != 0)) {
+                    continue;
+                }
+
+                split(qxybounds, char('a' + j), lower, upper);
+                tightenunchecked(lower);
+                tightenunchecked(upper);
+
+                if (valid(lower) && valid(upper)) {
+                    break;
+                }
+            }
+
+            if (attempt == 32) {
+                qxybounds = rootqxybounds;
+                tighten(qxybounds);
+                level = 0;
+                continue;
+            }
+
+            qxybounds = ((random() % 2) == 0) ? lower : upper;
+        }
+
+        // alpha between 1/16 and 15/16, betas between 2^-6 and 1
+
+        leaf.qxybounds = qxybounds;
+        leaf.leaf.alpha = (UINT64_C(1) << 52) + random() % (UINT64_C(14) << 52);
+
+        for (uint64_t &beta : leaf.leaf.beta) {
+            beta = (UINT64_C(1) << 50) + random() % ((UINT64_C(1) << 56) - (UINT64_C(1) << 50));
+        }
+    }
+
+    return leafs;
+}
+
+// runs of consecutive leaves, spread evenly over the certificate, so that the caches see realistic neighbours
+
+template <typename Format>
+static std::vector<benchleaf_t> sampled(const Format &format, uint64_t leafcount)
+{
+    const uint64_t runs = std::max(uint64_t(1), std::min(leafcount, uint64_t(sampleleafs)) / samplerun);
+    const uint64_t stride = std::max(uint64_t(samplerun), leafcount / runs);
+    std::vector<benchleaf_t> leafs;
+    uint64_t index = 0;
+
+    walk(format, [&](const qxybounds_t &qxybounds, const leaf_t &leaf) {
+        if ((index++ % stride) < samplerun) {
+            leafs.push_back(benchleaf_t{qxybounds, leaf});
+        }
+    });
+
+    return leafs;
+}
+
+template <typename Format>
+static uint64_t benchtraversal(const Format &format, size_t bytes)
+{
+    uint64_t leafs = 0;
+    uint64_t passes = 0;
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    double seconds = 0.0;
+
+    do {
+        walk(format, [&](const qxybounds_t &, const leaf_t &) { ++leafs; });
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        ++passes;
+    } while (seconds < benchseconds);
+
+    leafs /= passes;
+    printf("traversal: %llu leaves, %.0f ns/leaf, %.1f MB/s\n", static_cast<unsigned long long>(leafs), 1e9 * seconds / double(passes * leafs), 1e-6 * double(passes * bytes) / seconds);
+    return leafs;
+}
+
+// the caches start empty in every pass, and the counting pass (of the calls of log and exp and of the allocations) is
+// separate so that the timing is not affected
+
+template <typename Backend>
+static uint64_t benchverify(const char *leafsname, const std::vector<benchleaf_t> &leafs, const parameters_t &parameters, const char *backendname, int precision)
+{
+    result_t result = {};
+    uint64_t passes = 0;
+    double seconds = 0.0;
+
+    do {
+        Verifier<Backend> verifier(parameters.rate.c_str(), parameters.lowerbound.c_str());
+        const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+        for (const benchleaf_t &leaf : leafs) {
+            verifier.verify(leaf.qxybounds, leaf.leaf, result);
+        }
+
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        ++passes;
+    } while (seconds < benchseconds);
+
+    Verifier<Backend> verifier(parameters.rate.c_str(), parameters.lowerbound.c_str());
+    uint64_t conclusive = 0;
+    threadstats = stats_t();
+    statsenabled = true;
+    const uint64_t allocationsbefore = allocations;
+
+    for (const benchleaf_t &leaf : leafs) {
+        conclusive += verifier.verify(leaf.qxybounds, leaf.leaf, result) ? 1 : 0;
+    }
+
+    const uint64_t leafallocations = allocations - allocationsbefore;
+    statsenabled = false;
+    const double count = double(leafs.size());
+    printf("%-9s %-5s %5d %10.0f %10.2f %10.2f %7llu/%llu %11.2f\n", leafsname, backendname, precision, 1e9 * seconds / (double(passes) * count), double(threadstats.logs) / count, double(threadstats.exps) / count, static_cast<unsigned long long>(conclusive), static_cast<unsigned long long>(leafs.size()), double(leafallocations) / count);
+    return leafallocations;
+}
+
+// returns false if a leaf allocates with any backend, which should not happen also when the value of the leaf is
+// printed (the temporaries of MPFR and MPFI come from the arena, see arena.h)
+
+static bool benchleafs(const char *leafsname, const std::vector<benchleaf_t> &leafs, const parameters_t &parameters)
+{
+    if (leafs.empty()) {
+        return true;
+    }
+
+    // MPFR needs 60 bits to hold the numbers of the certificate exactly
+
+    uint64_t leafallocations = benchverify<MpfiBackend<53>>(leafsname, leafs, parameters, "mpfi", 53);
+    leafallocations += benchverify<MpfiBackend<64>>(leafsname, leafs, parameters, "mpfi", 64);
+    leafallocations += benchverify<MpfiBackend<68>>(leafsname, leafs, parameters, "mpfi", 68);
+    leafallocations += benchverify<MpfiBackend<128>>(leafsname, leafs, parameters, "mpfi", 128);
+    leafallocations += benchverify<MpfrBackend<64>>(leafsname, leafs, parameters, "mpfr", 64);
+    leafallocations += benchverify<MpfrBackend<68>>(leafsname, leafs, parameters, "mpfr", 68);
+    leafallocations += benchverify<MpfrBackend<128>>(leafsname, leafs, parameters, "mpfr", 128);
+    leafallocations += benchverify<DdBackend>(leafsname, leafs, parameters, "dd", 106);
+
+    if (leafallocations != 0) {
+        printf("the %s leaves allocate memory\n", leafsname);
+        return false;
+    }
+
+    return true;
+}
+
+template <typename Format>
+static bool benchcertificate(const Format &format, size_t bytes)
+{
+    const uint64_t leafcount = benchtraversal(format, bytes);
+    printf("leaves    backend  bits    ns/leaf  logs/leaf  exps/leaf  conclusive  allocs/leaf\n");
+    parameters_t parameters;
+    resolveparameters(format.parameters(), parameters_t(), parameters);
+    return benchleafs("sampled", sampled(format, leafcount), parameters);
+}
+
+int main(int argc, char **argv)
+{
+    if ((argc > 2) || ((argc == 2) && (argv[1][0] == '-'))) {
+        printf("usage: %s [input.txt | input.bin]\n", argv[0]);
+        return 1;
+    }
+
+    countallocations();
+    const char *filename = (argc == 2) ? argv[1] : "input.txt";
+    const MappedFile input(filename);
+    bool allocationfree = true;
+
+    if (!input.valid()) {
+        printf("cannot open %s, only synthetic leaves\n", filename);
+        printf("leaves    backend  bits    ns/leaf  logs/leaf  exps/leaf  conclusive  allocs/leaf\n");
+    } else if (isbinary(input.data(), input.size())) {
+        allocationfree = benchcertificate(BinaryFormat(input.data(), input.size()), input.size());
+    } else {
+        allocationfree = benchcertificate(TextFormat(input.data(), input.size()), input.size());
+    }
+
+    allocationfree = benchleafs("shallow", synthetic(10, 1), parameters_t{certificaterate, certificatelowerbound}) && allocationfree;
+    allocationfree = benchleafs("deep", synthetic(30, 2), parameters_t{certificaterate, certificatelowerbound}) && allocationfree;
+
+    if (!allocationfree) {
+        return 1;
+    }
+
+    printf("finish\n");
+    return 0;
+}
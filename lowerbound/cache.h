@@ -0,0 +1,94 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <sys/types.h>
+#include <utility>
+#include <vector>
+
+// direct-mapped cache of per-coordinate values that survives from one leaf to the next: in a depth-first walk,
+// neighbouring leaves share most of the coordinates of their extreme points
+
+static const uint cachebits = 12;
+
+struct cachecounters_t {
+    std::atomic<uint64_t> lookups{0};
+    std::atomic<uint64_t> hits{0};
+};
+
+static inline uint cacheslot(int32_t coordinate)
+{
+    return uint((uint32_t(coordinate) * UINT32_C(2654435761)) >> (32 - cachebits));
+}
+
+static inline uint cacheslot(const std::pair<int32_t, uint64_t> &key)
+{
+    return cacheslot(int32_t(uint32_t(key.first) ^ uint32_t(key.second) ^ uint32_t(key.second >> 32)));
+}
+
+static inline void printcounters(const char *name, const cachecounters_t &counters)
+{
+    const uint64_t lookups = counters.lookups.load();
+    const uint64_t hits = counters.hits.load();
+    fprintf(stderr, "%s cache: %llu of %llu lookups hit (%.1f%%)\n", name, static_cast<unsigned long long>(hits), static_cast<unsigned long long>(lookups), (lookups != 0) ? (100.0 * double(hits) / double(lookups)) : 0.0);
+}
+
+template <typename Key, typename Value>
+class Cache
+{
+  public:
+    // the counters are shared by the caches of all workers and only updated when a cache is destroyed
+
+    explicit Cache(cachecounters_t &counters) : counters(counters), used(1u << cachebits, false), keys(1u << cachebits), values(1u << cachebits) {}
+    ~Cache();
+
+    Value *find(const Key &key);
+    Value &insert(const Key &key);
+
+  private:
+    Cache(const Cache &) = delete;
+    Cache &operator=(const Cache &) = delete;
+
+    cachecounters_t &counters;
+    uint64_t lookups = 0;
+    uint64_t hits = 0;
+    std::vector<bool> used;
+    std::vector<Key> keys;
+    std::vector<Value> values;
+};
+
+template <typename Key, typename Value>
+Cache<Key, Value>::~Cache()
+{
+    counters.lookups += lookups;
+    counters.hits += hits;
+}
+
+template <typename Key, typename Value>
+Value *Cache<Key, Value>::find(const Key &key)
+{
+    const uint slot = cacheslot(key);
+    ++lookups;
+
+    if (!used.at(slot) || (keys.at(slot) != key)) {
+        return nullptr;
+    }
+
+    ++hits;
+    return &values.at(slot);
+}
+
+template <typename Key, typename Value>
+Value &Cache<Key, Value>::insert(const Key &key)
+{
+    // the previous occupant of the slot is evicted
+
+    const uint slot = cacheslot(key);
+    used.at(slot) = true;
+    keys.at(slot) = key;
+    return values.at(slot);
+}
+
+#endif
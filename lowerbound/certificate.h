@@ -0,0 +1,542 @@
+#ifndef CERTIFICATE_H
+#define CERTIFICATE_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "traversal.h"
+
+// every number in a certificate has the form h.hhhhhhhhhhhhhh (hex), i.e., it is a 60-bit integer divided by 2^56
+
+static const int leafexponent = 56;
+static const uint alphabits = 56;
+static const uint betabits = 60;
+static const uint tagbits = 3;
+static const uint leafbits = tagbits + alphabits + 9 * betabits;
+static const std::string binarymagic = "qxycert\n";
+static const uint32_t binaryversion = 1;
+static const uint32_t dictionaryversion = 2;
+static const uint32_t parametersversion = 3;
+static const size_t linesize = 171;
+static const size_t maxparameterssize = 256;
+
+// the rate and the lower bound (59) that the original certificate establishes
+
+static const char *const certificaterate = "0x0.07b28";               // 3941 / 2^17
+static const char *const certificatelowerbound = "0x0.cfca8923023b33"; // 58488010525784883 / 2^56
+
+// the rate and the lower bound for which a certificate was generated, as given to generate (e.g., "0x0.07b28" and
+// "0x0.cfca8923023b33"); both are empty for a certificate without them, such as the original input.txt
+
+struct parameters_t {
+    std::string rate;
+    std::string lowerbound;
+};
+
+static inline parameters_t parseparameters(const std::string &text)
+{
+    // "rate lowerbound"
+
+    const size_t separator = text.find(' ');
+    CHECK((text.size() <= maxparameterssize) && (text.find('\n') == std::string::npos));
+    CHECK((separator != std::string::npos) && (separator != 0) && (separator + 1 < text.size()));
+    CHECK(text.find(' ', separator + 1) == std::string::npos);
+    return parameters_t{text.substr(0, separator), text.substr(separator + 1)};
+}
+
+static inline std::string formatparameters(const parameters_t &parameters)
+{
+    const std::string text = parameters.rate + " " + parameters.lowerbound;
+    CHECK((parseparameters(text).rate == parameters.rate) && (parseparameters(text).lowerbound == parameters.lowerbound));
+    return text;
+}
+
+struct leaf_t {
+    // alpha = alpha / 2^leafexponent
+    // beta(x, y) = beta.at(3 * x + y) / 2^leafexponent
+
+    uint64_t alpha;
+    std::array<uint64_t, 9> beta;
+};
+
+inline bool operator==(const leaf_t &a, const leaf_t &b)
+{
+    return (a.alpha == b.alpha) && (a.beta == b.beta);
+}
+
+inline bool operator!=(const leaf_t &a, const leaf_t &b)
+{
+    return !(a == b);
+}
+
+inline bool operator<(const leaf_t &a, const leaf_t &b)
+{
+    return (a.alpha != b.alpha) ? (a.alpha < b.alpha) : (a.beta < b.beta);
+}
+
+// read-only mapping of a whole certificate file, so that the formats below can walk it in place
+
+class MappedFile
+{
+  public:
+    explicit MappedFile(const char *filename);
+    ~MappedFile();
+
+    bool valid() const { return opened; }
+    const char *data() const { return address; }
+    size_t size() const { return length; }
+
+  private:
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool opened = false;
+    const char *address = nullptr;
+    size_t length = 0;
+};
+
+inline MappedFile::MappedFile(const char *filename)
+{
+    const int descriptor = open(filename, O_RDONLY);
+    struct stat status;
+
+    if ((descriptor < 0) || (fstat(descriptor, &status) != 0)) {
+        if (descriptor >= 0) {
+            close(descriptor);
+        }
+
+        return;
+    }
+
+    length = size_t(status.st_size);
+
+    if (length != 0) {
+        void *mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        close(descriptor);
+
+        if (mapping == MAP_FAILED) {
+            return;
+        }
+
+        madvise(mapping, length, MADV_WILLNEED);
+        address = static_cast<const char *>(mapping);
+    } else {
+        close(descriptor);
+    }
+
+    opened = true;
+}
+
+inline MappedFile::~MappedFile()
+{
+    if (address != nullptr) {
+        munmap(const_cast<char *>(address), length);
+    }
+}
+
+static inline uint64_t parsefield(const char *field)
+{
+    // decode the 15 hex digits straight into the integer, collecting invalid characters in one flag
+
+    uint64_t value = 0;
+    bool invalid = (field[1] != '.');
+
+    for (uint i = 0; i < 16; ++i) {
+        if (i == 1) {
+            continue;
+        }
+
+        const uint digit = uint8_t(field[i]) - '0';
+        const uint letter = (uint8_t(field[i]) | 0x20) - 'a';
+        invalid |= ((digit >= 10) && (letter >= 6));
+        value = (value << 4) | ((digit < 10) ? digit : (letter + 10));
+    }
+
+    CHECK(!invalid);
+    return value;
+}
+
+// text certificate (input.txt): one node per line, "a" to "f" select a split and "v" is followed by alpha and the
+// nine betas, each as a 16-character field preceded by a separator (the "v" itself in the case of alpha); an
+// optional first line "p rate lowerbound" holds the parameters
+
+class TextFormat
+{
+  public:
+    using record_t = leaf_t;
+
+    TextFormat(const char *data, size_t size);
+    TextFormat(const TextFormat &format, size_t size) : data(format.data), size(size), header(format.header) {}
+
+    static size_t extent(size_t offset) { return offset + linesize; } // bytes that the node at offset may need
+    size_t begin() const { return header; }
+    size_t end() const { return size; }
+    char kind(size_t offset) const;
+    size_t next(size_t offset) const;
+    void record(size_t offset, leaf_t &leaf) const;
+    parameters_t parameters() const;
+
+  private:
+    const char *data;
+    size_t size;
+    size_t header = 0; // size of the line with the parameters
+};
+
+inline TextFormat::TextFormat(const char *data, size_t size) : data(data), size(size)
+{
+    if ((size != 0) && (data[0] == 'p')) {
+        CHECK((size >= 2) && (data[1] == ' '));
+        const void *newline = memchr(data, '\n', std::min(size, maxparameterssize + 3));
+        CHECK(newline != nullptr);
+        header = size_t(static_cast<const char *>(newline) - data) + 1;
+        parameters();
+    }
+}
+
+inline parameters_t TextFormat::parameters() const
+{
+    return (header != 0) ? parseparameters(std::string(data + 2, header - 3)) : parameters_t();
+}
+
+inline char TextFormat::kind(size_t offset) const
+{
+    CHECK(offset < size);
+    return data[offset];
+}
+
+inline size_t TextFormat::next(size_t offset) const
+{
+    const void *newline = memchr(data + offset, '\n', size - offset);
+    return ((newline != nullptr) ? size_t(static_cast<const char *>(newline) - data) : size) + 1;
+}
+
+inline void TextFormat::record(size_t offset, leaf_t &leaf) const
+{
+    CHECK(next(offset) - offset == linesize);
+    leaf.alpha = parsefield(data + offset + 1);
+
+    for (uint i = 0; i < 9; ++i) {
+        leaf.beta.at(i) = parsefield(data + offset + 17 * i + 18);
+    }
+}
+
+// binary certificate (input.bin): the magic string and a 32-bit little-endian version, followed by a bit stream
+// (least significant bit first) that holds a 3-bit tag per node, 0 to 5 for the splits "a" to "f" and 7 for "v";
+// the tag of a leaf is followed by alpha as a 56-bit integer and the nine betas as 60-bit integers
+//
+// version 2 adds a dictionary of leaves that occur more than once: the version is followed by the 32-bit number of
+// entries and the entries (alpha and the betas as above, without a tag), and tag 6 is a leaf given by the index of
+// its entry, with just enough bits for the largest index
+//
+// version 3 adds the parameters: the version is followed by the 32-bit size of the text "rate lowerbound" and the
+// text, and then by the dictionary as in version 2 (which may be empty)
+
+static inline bool isbinary(const char *data, size_t size)
+{
+    return (size >= binarymagic.size()) && (memcmp(data, binarymagic.data(), binarymagic.size()) == 0);
+}
+
+class BinaryFormat
+{
+  public:
+    using record_t = leaf_t;
+
+    BinaryFormat(const char *data, size_t size);
+    BinaryFormat(const BinaryFormat &format, size_t size);
+
+    static size_t extent(size_t offset) { return (offset + leafbits + 7) / 8; }
+    size_t begin() const { return nodes; }
+    size_t end() const { return 8 * size; }
+    char kind(size_t offset) const;
+    size_t next(size_t offset) const;
+    void record(size_t offset, leaf_t &leaf) const;
+    uint32_t dictionarysize() const { return entries; }
+    parameters_t parameters() const;
+
+  private:
+    uint64_t tag(size_t offset) const;
+    uint64_t bits(size_t offset, uint count) const;
+
+    const char *data;
+    size_t size;
+    uint32_t entries = 0;
+    uint indexbits = 0;
+    size_t dictionary = 0; // offset of the first entry
+    size_t nodes = 0;      // offset of the root
+    size_t parametersoffset = 0; // bytes
+    uint32_t parameterssize = 0;
+};
+
+static inline uint dictionaryindexbits(uint32_t entries)
+{
+    uint indexbits = 0;
+
+    while ((uint64_t(1) << indexbits) < entries) {
+        ++indexbits;
+    }
+
+    return indexbits;
+}
+
+inline BinaryFormat::BinaryFormat(const char *data, size_t size) : data(data), size(size)
+{
+    CHECK(isbinary(data, size));
+    const uint64_t version = bits(8 * binarymagic.size(), 32);
+    CHECK((version == binaryversion) || (version == dictionaryversion) || (version == parametersversion));
+    nodes = 8 * (binarymagic.size() + 4);
+
+    if (version == parametersversion) {
+        parameterssize = uint32_t(bits(nodes, 32));
+        CHECK(parameterssize <= maxparameterssize);
+        parametersoffset = nodes / 8 + 4;
+        nodes += 8 * (4 + size_t(parameterssize));
+        CHECK(nodes <= 8 * size);
+        parameters();
+    }
+
+    if (version != binaryversion) {
+        entries = uint32_t(bits(nodes, 32));
+        indexbits = dictionaryindexbits(entries);
+        dictionary = nodes + 32;
+        nodes = dictionary + size_t(entries) * (leafbits - tagbits);
+    }
+}
+
+inline BinaryFormat::BinaryFormat(const BinaryFormat &format, size_t size) : BinaryFormat(format)
+{
+    this->size = size;
+}
+
+inline parameters_t BinaryFormat::parameters() const
+{
+    return (parameterssize != 0) ? parseparameters(std::string(data + parametersoffset, parameterssize)) : parameters_t();
+}
+
+inline uint64_t BinaryFormat::tag(size_t offset) const
+{
+    const uint64_t tag = bits(offset, tagbits);
+    CHECK((tag != 6) || (entries != 0));
+    return tag;
+}
+
+inline char BinaryFormat::kind(size_t offset) const
+{
+    const uint64_t tag = this->tag(offset);
+    return (tag >= 6) ? 'v' : char('a' + tag);
+}
+
+inline size_t BinaryFormat::next(size_t offset) const
+{
+    const uint64_t tag = this->tag(offset);
+    return offset + ((tag == 7) ? leafbits : (tag == 6) ? (tagbits + indexbits) : tagbits);
+}
+
+inline void BinaryFormat::record(size_t offset, leaf_t &leaf) const
+{
+    CHECK(kind(offset) == 'v');
+
+    if (tag(offset) == 6) {
+        const uint64_t index = bits(offset + tagbits, indexbits);
+        CHECK(index < entries);
+        offset = dictionary + size_t(index) * (leafbits - tagbits);
+    } else {
+        offset += tagbits;
+    }
+
+    leaf.alpha = bits(offset, alphabits);
+    offset += alphabits;
+
+    for (uint i = 0; i < 9; ++i) {
+        leaf.beta.at(i) = bits(offset, betabits);
+        offset += betabits;
+    }
+}
+
+inline uint64_t BinaryFormat::bits(size_t offset, uint count) const
+{
+    CHECK(offset + count <= 8 * size);
+    uint64_t value = 0;
+
+    for (uint i = 0; i < count;) {
+        const uint shift = (offset + i) % 8;
+        const uint width = std::min(8 - shift, count - i);
+        const uint64_t byte = uint8_t(data[(offset + i) / 8]);
+        value |= ((byte >> shift) & ((1u << width) - 1)) << i;
+        i += width;
+    }
+
+    return value;
+}
+
+// writer of the text format, one line per node
+
+class TextWriter
+{
+  public:
+    void parameters(const parameters_t &parameters);
+    void split(char kind);
+    void leaf(const leaf_t &leaf);
+    const std::string &finish() const { return output; }
+    size_t size() const { return output.size(); }
+    void truncate(size_t size) { output.resize(size); }
+
+  private:
+    void field(char separator, uint64_t value);
+
+    std::string output;
+};
+
+inline void TextWriter::parameters(const parameters_t &parameters)
+{
+    // the first line, if any
+
+    CHECK(output.empty());
+    output += "p " + formatparameters(parameters) + "\n";
+}
+
+inline void TextWriter::split(char kind)
+{
+    CHECK((kind >= 'a') && (kind <= 'f'));
+    output.push_back(kind);
+    output.push_back('\n');
+}
+
+inline void TextWriter::leaf(const leaf_t &leaf)
+{
+    field('v', leaf.alpha);
+
+    for (uint i = 0; i < 9; ++i) {
+        field(' ', leaf.beta.at(i));
+    }
+
+    output.push_back('\n');
+}
+
+inline void TextWriter::field(char separator, uint64_t value)
+{
+    static const char *digits = "0123456789abcdef";
+    CHECK((value >> 60) == 0);
+    output.push_back(separator);
+
+    for (int shift = 56; shift >= 0; shift -= 4) {
+        output.push_back(digits[(value >> shift) & 15]);
+
+        if (shift == 56) {
+            output.push_back('.');
+        }
+    }
+}
+
+// writer of the binary format; with a non-empty dictionary (of distinct leaves), version 2 is written and the leaves
+// in the dictionary are written as indices, and with parameters, version 3 is written
+
+class BinaryWriter
+{
+  public:
+    explicit BinaryWriter(const std::vector<leaf_t> &dictionary = std::vector<leaf_t>(), const parameters_t &parameters = parameters_t());
+
+    void split(char kind);
+    void leaf(const leaf_t &leaf);
+    const std::string &finish();
+
+  private:
+    void entry(const leaf_t &leaf);
+    void bits(uint64_t value, uint count);
+
+    std::string output;
+    uint64_t pending = 0;
+    uint pendingbits = 0;
+    std::map<leaf_t, uint32_t> indices;
+    uint indexbits = 0;
+};
+
+inline BinaryWriter::BinaryWriter(const std::vector<leaf_t> &dictionary, const parameters_t &parameters) : output(binarymagic)
+{
+    const bool withparameters = !parameters.rate.empty();
+
+    if (dictionary.empty() && !withparameters) {
+        bits(binaryversion, 32);
+        return;
+    }
+
+    CHECK(dictionary.size() <= UINT32_MAX);
+    bits(withparameters ? parametersversion : dictionaryversion, 32);
+
+    if (withparameters) {
+        const std::string text = formatparameters(parameters);
+        bits(text.size(), 32);
+        output += text;
+    }
+
+    bits(dictionary.size(), 32);
+    indexbits = dictionaryindexbits(uint32_t(dictionary.size()));
+
+    for (const leaf_t &leaf : dictionary) {
+        CHECK(indices.emplace(leaf, uint32_t(indices.size())).second);
+        entry(leaf);
+    }
+}
+
+inline void BinaryWriter::split(char kind)
+{
+    CHECK((kind >= 'a') && (kind <= 'f'));
+    bits(uint64_t(kind - 'a'), tagbits);
+}
+
+inline void BinaryWriter::leaf(const leaf_t &leaf)
+{
+    const std::map<leaf_t, uint32_t>::const_iterator index = indices.find(leaf);
+
+    if (index != indices.end()) {
+        bits(6, tagbits);
+        bits(index->second, indexbits);
+        return;
+    }
+
+    bits(7, tagbits);
+    entry(leaf);
+}
+
+inline void BinaryWriter::entry(const leaf_t &leaf)
+{
+    CHECK((leaf.alpha >> alphabits) == 0);
+    bits(leaf.alpha, alphabits);
+
+    for (uint i = 0; i < 9; ++i) {
+        CHECK((leaf.beta.at(i) >> betabits) == 0);
+        bits(leaf.beta.at(i), betabits);
+    }
+}
+
+inline const std::string &BinaryWriter::finish()
+{
+    if (pendingbits != 0) {
+        bits(0, 8 - pendingbits);
+    }
+
+    return output;
+}
+
+inline void BinaryWriter::bits(uint64_t value, uint count)
+{
+    for (uint i = 0; i < count; ++i) {
+        pending |= ((value >> i) & 1) << pendingbits;
+
+        if (++pendingbits == 8) {
+            output.push_back(char(pending));
+            pending = 0;
+            pendingbits = 0;
+        }
+    }
+}
+
+#endif
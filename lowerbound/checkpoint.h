@@ -0,0 +1,151 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <sys/types.h>
+#include <unistd.h>
+#include <vector>
+
+#include "traversal.h"
+
+// checkpoints of the serial traversal: the stack, the offset of the next node and a running digest of the printed
+// values are written every few minutes (to a temporary file that is then renamed), so that a killed run can be
+// continued with the same output and the same final digest as an uninterrupted run
+
+static const std::string checkpointmagic = "qxyckpt\n";
+static const uint32_t checkpointversion = 1;
+static const double checkpointseconds = 60.0;
+
+class Checkpoint
+{
+  public:
+    Checkpoint(const char *filename, size_t certificatesize) : filename(filename), certificatesize(certificatesize) {}
+
+    bool load(walkstate_t &state);
+    void update(const walkstate_t &state, const result_t &result);
+    void finish();
+
+  private:
+    void save(const walkstate_t &state) const;
+
+    std::string filename;
+    size_t certificatesize;
+    uint64_t digest = UINT64_C(14695981039346656037); // FNV-1a offset basis
+    std::chrono::steady_clock::time_point saved = std::chrono::steady_clock::now();
+};
+
+inline bool Checkpoint::load(walkstate_t &state)
+{
+    FILE *file = fopen(filename.c_str(), "rb");
+
+    if (file == nullptr) {
+        return false;
+    }
+
+    std::string magic(checkpointmagic.size(), '\0');
+    uint32_t version = 0;
+    uint64_t size = 0;
+    uint64_t offset = 0;
+    uint64_t count = 0;
+
+    CHECK(fread(&magic.at(0), 1, magic.size(), file) == magic.size());
+    CHECK(magic == checkpointmagic);
+    CHECK(fread(&version, sizeof(version), 1, file) == 1);
+    CHECK(version == checkpointversion);
+    CHECK(fread(&size, sizeof(size), 1, file) == 1);
+    CHECK(size == certificatesize);
+    CHECK(fread(&offset, sizeof(offset), 1, file) == 1);
+    CHECK(fread(&state.leafs, sizeof(state.leafs), 1, file) == 1);
+    CHECK(fread(&digest, sizeof(digest), 1, file) == 1);
+    CHECK(fread(&count, sizeof(count), 1, file) == 1);
+
+    state.offset = size_t(offset);
+    state.stack.resize(size_t(count));
+    CHECK(fread(state.stack.data(), sizeof(qxybounds_t), state.stack.size(), file) == state.stack.size());
+    CHECK(fgetc(file) == EOF);
+    CHECK(fclose(file) == 0);
+    return true;
+}
+
+inline void Checkpoint::update(const walkstate_t &state, const result_t &result)
+{
+    for (size_t i = 0; i < strlen(result.text.data()); ++i) {
+        digest = (digest ^ uint8_t(result.text.at(i))) * UINT64_C(1099511628211);
+    }
+
+    digest = (digest ^ uint8_t('\n')) * UINT64_C(1099511628211);
+
+    // the clock is cheap compared to a leaf, so it is read after every leaf
+
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    if (std::chrono::duration<double>(now - saved).count() >= checkpointseconds) {
+        save(state);
+        saved = now;
+    }
+}
+
+inline void Checkpoint::save(const walkstate_t &state) const
+{
+    // the printed values must be written before the checkpoint that claims them
+
+    CHECK(fflush(stdout) == 0);
+
+    const std::string temporary = filename + ".tmp";
+    FILE *file = fopen(temporary.c_str(), "wb");
+    CHECK(file != nullptr);
+
+    const uint64_t size = certificatesize;
+    const uint64_t offset = state.offset;
+    const uint64_t count = state.stack.size();
+
+    CHECK(fwrite(checkpointmagic.data(), 1, checkpointmagic.size(), file) == checkpointmagic.size());
+    CHECK(fwrite(&checkpointversion, sizeof(checkpointversion), 1, file) == 1);
+    CHECK(fwrite(&size, sizeof(size), 1, file) == 1);
+    CHECK(fwrite(&offset, sizeof(offset), 1, file) == 1);
+    CHECK(fwrite(&state.leafs, sizeof(state.leafs), 1, file) == 1);
+    CHECK(fwrite(&digest, sizeof(digest), 1, file) == 1);
+    CHECK(fwrite(&count, sizeof(count), 1, file) == 1);
+    CHECK(fwrite(state.stack.data(), sizeof(qxybounds_t), state.stack.size(), file) == state.stack.size());
+    CHECK(fflush(file) == 0);
+    CHECK(fsync(fileno(file)) == 0);
+    CHECK(fclose(file) == 0);
+    CHECK(rename(temporary.c_str(), filename.c_str()) == 0);
+}
+
+inline void Checkpoint::finish()
+{
+    // a finished run leaves no checkpoint behind, and the digest covers all printed values
+
+    CHECK((unlink(filename.c_str()) == 0) || (access(filename.c_str(), F_OK) != 0));
+    fprintf(stderr, "digest: %016llx\n", static_cast<unsigned long long>(digest));
+}
+
+// serial traversal that updates a checkpoint after every leaf, optionally continuing from the saved state
+
+template <typename Verifier, typename Format>
+void traverse(Verifier &verifier, const Format &format, Checkpoint &checkpoint, bool resume)
+{
+    walkstate_t state = {{rootqxybounds}, format.begin(), 0};
+    result_t result = {};
+
+    if (resume && checkpoint.load(state)) {
+        fprintf(stderr, "resuming after %llu leaves\n", static_cast<unsigned long long>(state.leafs));
+    }
+
+    walk(format, state, [&](const qxybounds_t &qxybounds, const typename Format::record_t &record) {
+        CHECK(verifier.verify(qxybounds, record, result));
+        resultsadd(result);
+        checkpoint.update(state, result);
+        statslap(finalcheck);
+    });
+
+    verifier.finish();
+    checkpoint.finish();
+}
+
+#endif
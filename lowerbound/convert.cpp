@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "certificate.h"
+#include "traversal.h"
+
+int main(int argc, char **argv)
+{
+    if (argc != 3) {
+        printf("usage: %s input.txt input.bin\n", argv[0]);
+        return 1;
+    }
+
+    const MappedFile input(argv[1]);
+
+    if (!input.valid()) {
+        printf("cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    // the leaves that occur more than once go to the dictionary
+
+    const TextFormat text(input.data(), input.size());
+    const Tree<TextFormat> tree(text);
+    std::vector<leaf_t> leafs;
+    std::vector<leaf_t> dictionary;
+    leaf_t leaf = {};
+
+    for (size_t index = 0; index < tree.nodecount(); ++index) {
+        const size_t offset = tree.node(index).offset;
+
+        if (text.kind(offset) == 'v') {
+            text.record(offset, leaf);
+            leafs.push_back(leaf);
+        }
+    }
+
+    std::sort(leafs.begin(), leafs.end());
+
+    for (size_t index = 1; index < leafs.size(); ++index) {
+        if ((leafs.at(index) == leafs.at(index - 1)) && (dictionary.empty() || (dictionary.back() != leafs.at(index)))) {
+            dictionary.push_back(leafs.at(index));
+        }
+    }
+
+    std::vector<leaf_t>().swap(leafs);
+
+    // write the nodes of the split tree in their original order
+
+    BinaryWriter writer(dictionary, text.parameters());
+
+    for (size_t index = 0; index < tree.nodecount(); ++index) {
+        const size_t offset = tree.node(index).offset;
+
+        if (text.kind(offset) == 'v') {
+            text.record(offset, leaf);
+            writer.leaf(leaf);
+        } else {
+            writer.split(text.kind(offset));
+        }
+    }
+
+    const std::string &output = writer.finish();
+
+    // read the result back and compare it with the original
+
+    const BinaryFormat binary(output.data(), output.size());
+    CHECK(binary.parameters().rate == text.parameters().rate);
+    CHECK(binary.parameters().lowerbound == text.parameters().lowerbound);
+    size_t offset = binary.begin();
+    leaf_t binaryleaf = {};
+
+    for (size_t index = 0; index < tree.nodecount(); ++index) {
+        const size_t textoffset = tree.node(index).offset;
+        CHECK(binary.kind(offset) == text.kind(textoffset));
+
+        if (text.kind(textoffset) == 'v') {
+            text.record(textoffset, leaf);
+            binary.record(offset, binaryleaf);
+            CHECK(binaryleaf.alpha == leaf.alpha);
+            CHECK(binaryleaf.beta == leaf.beta);
+        }
+
+        offset = binary.next(offset);
+    }
+
+    std::ofstream outfile(argv[2], std::ios::binary);
+    outfile.write(output.data(), std::streamsize(output.size()));
+
+    if (!outfile) {
+        printf("cannot write %s\n", argv[2]);
+        return 1;
+    }
+
+    printf("%zu nodes (%zu leaves, %zu in the dictionary), %zu bytes -> %zu bytes\n", tree.nodecount(), tree.leafcount(), dictionary.size(), input.size(), output.size());
+    return 0;
+}
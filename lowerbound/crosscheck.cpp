@@ -0,0 +1,216 @@
+#include <condition_variable>
+
+#include "../common/mpfibackend.h"
+#include "../common/mpfrbackend.h"
+#include "verifier.h"
+
+static const int precision = 68;
+static const size_t queuesize = 4096;
+
+// a ring of leaves that is filled by the traversal and read by one thread per backend; a slot is only reused once
+// both backends have verified it, and the results are printed in the order of the certificate at that point
+
+class LeafQueue
+{
+  public:
+    LeafQueue() : slots(queuesize) {}
+
+    void push(const qxybounds_t &qxybounds, const leaf_t &leaf);
+    bool pop(uint backend, size_t &index);
+    void done(uint backend);
+    void close();
+
+    const qxybounds_t &qxybounds(size_t index) const { return slots.at(index % queuesize).qxybounds; }
+    const leaf_t &leaf(size_t index) const { return slots.at(index % queuesize).leaf; }
+    result_t &result(size_t index, uint backend) { return slots.at(index % queuesize).results.at(backend); }
+    uint64_t differences() const { return mismatches; }
+
+  private:
+    struct slot_t {
+        qxybounds_t qxybounds;
+        leaf_t leaf;
+        std::array<result_t, 2> results;
+    };
+
+    size_t verifiedall() const { return std::min(verified.at(0), verified.at(1)); }
+    void print(std::unique_lock<std::mutex> &lock);
+
+    std::vector<slot_t> slots;
+    std::mutex lock;
+    std::condition_variable changed;
+    size_t pushed = 0;
+    size_t printed = 0;
+    std::array<size_t, 2> verified = {};
+    bool closed = false;
+    uint64_t mismatches = 0;
+};
+
+void LeafQueue::print(std::unique_lock<std::mutex> &lock)
+{
+    const size_t end = verifiedall();
+    lock.unlock();
+
+    for (; printed < end; ++printed) {
+        const slot_t &slot = slots.at(printed % queuesize);
+        mismatches += (slot.results.at(0).text != slot.results.at(1).text) ? 1 : 0;
+        printf("%s\n", slot.results.at(0).text.data());
+    }
+
+    lock.lock();
+}
+
+void LeafQueue::push(const qxybounds_t &qxybounds, const leaf_t &leaf)
+{
+    std::unique_lock<std::mutex> guard(lock);
+
+    // print what both backends have verified, and wait for them if the ring is full
+
+    while (true) {
+        print(guard);
+
+        if (pushed - printed < queuesize) {
+            break;
+        }
+
+        if (verifiedall() == printed) {
+            changed.wait(guard);
+        }
+    }
+
+    guard.unlock();
+    slots.at(pushed % queuesize).qxybounds = qxybounds;
+    slots.at(pushed % queuesize).leaf = leaf;
+    guard.lock();
+
+    ++pushed;
+    changed.notify_all();
+}
+
+bool LeafQueue::pop(uint backend, size_t &index)
+{
+    std::unique_lock<std::mutex> guard(lock);
+
+    while ((verified.at(backend) == pushed) && !closed) {
+        changed.wait(guard);
+    }
+
+    index = verified.at(backend);
+    return index != pushed;
+}
+
+void LeafQueue::done(uint backend)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    ++verified.at(backend);
+    changed.notify_all();
+}
+
+void LeafQueue::close()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    closed = true;
+    changed.notify_all();
+
+    while (true) {
+        print(guard);
+
+        if (printed == pushed) {
+            break;
+        }
+
+        if (verifiedall() == printed) {
+            changed.wait(guard);
+        }
+    }
+}
+
+template <typename Backend>
+static void consume(LeafQueue &queue, uint backend, const char *ratestr, const char *lowerboundstr)
+{
+    Verifier<Backend> verifier(ratestr, lowerboundstr);
+    size_t index = 0;
+
+    while (queue.pop(backend, index)) {
+        CHECK(verifier.verify(queue.qxybounds(index), queue.leaf(index), queue.result(index, backend)));
+        queue.done(backend);
+    }
+}
+
+// single pass over the certificate: the tree is walked once and every leaf is verified with MPFI and with MPFR on
+// two threads, so that the run takes about as long as the slower backend alone
+
+template <typename Format>
+static void crosscheck(const Format &format, const parameters_t &parameters)
+{
+    LeafQueue queue;
+    std::thread mpfi(consume<MpfiBackend<precision>>, std::ref(queue), 0, parameters.rate.c_str(), parameters.lowerbound.c_str());
+    std::thread mpfr(consume<MpfrBackend<precision>>, std::ref(queue), 1, parameters.rate.c_str(), parameters.lowerbound.c_str());
+
+    walk(format, [&](const qxybounds_t &qxybounds, const leaf_t &leaf) { queue.push(qxybounds, leaf); });
+    queue.close();
+    mpfi.join();
+    mpfr.join();
+
+    fprintf(stderr, "mpfi and mpfr print different values for %llu leaves\n", static_cast<unsigned long long>(queue.differences()));
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<const char *> filenames;
+    parameters_t options;
+    bool usage = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if ((std::string(argv[i]) == "--rate") && (i + 1 < argc)) {
+            options.rate = argv[++i];
+        } else if ((std::string(argv[i]) == "--lowerbound") && (i + 1 < argc)) {
+            options.lowerbound = argv[++i];
+        } else {
+            filenames.push_back(argv[i]);
+            usage = usage || (argv[i][0] == '-');
+        }
+    }
+
+    if (usage) {
+        printf("usage: %s [--rate 0x0.hhh] [--lowerbound 0x0.hhh] [input.txt | input.bin | part ...]\n", argv[0]);
+        return 1;
+    }
+
+    if (filenames.empty()) {
+        filenames.push_back("input.txt");
+    }
+
+    const StreamedInput input(filenames);
+
+    if (!input.reserved()) {
+        printf("cannot reserve %zu bytes of address space for the decompressed certificate\n", streamcapacity);
+        return 1;
+    }
+
+    if (!input.valid()) {
+        printf("cannot open %s\n", input.failedname());
+        return 1;
+    }
+
+    parameters_t parameters;
+
+    if (!resolveparameters(certificateparameters(input), options, parameters)) {
+        printf("the certificate is for rate %s and lower bound %s\n", parameters.rate.c_str(), parameters.lowerbound.c_str());
+        return 1;
+    }
+
+    const bool binary = isbinary(input.data(), input.wait(binarymagic.size()));
+
+    if (input.mapped() && binary) {
+        crosscheck(BinaryFormat(input.data(), input.size()), parameters);
+    } else if (input.mapped()) {
+        crosscheck(TextFormat(input.data(), input.size()), parameters);
+    } else if (binary) {
+        crosscheck(StreamedFormat<BinaryFormat>(input), parameters);
+    } else {
+        crosscheck(StreamedFormat<TextFormat>(input), parameters);
+    }
+
+    printf("finish\n");
+    return 0;
+}
@@ -0,0 +1,7 @@
+#include "../common/ddbackend.h"
+#include "verifier.h"
+
+int main(int argc, char **argv)
+{
+    return verifiermain<DdBackend>(argc, argv);
+}
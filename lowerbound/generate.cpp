@@ -0,0 +1,161 @@
+#include <condition_variable>
+#include <fstream>
+
+#include "../common/arguments.h"
+#include "generator.h"
+
+// generation of a certificate in the text format with Generator; the boxes below taskdepth are generated as
+// independent tasks on all threads
+
+static const uint taskdepth = 10;
+
+// the top of the tree is generated serially, and every box at taskdepth becomes a task whose subtree is written in
+// its place once it is done
+
+struct item_t {
+    std::string text;
+    bool task;
+    qxybounds_t qxybounds;
+};
+
+static void expand(Generator &generator, qxybounds_t qxybounds, uint depth, std::vector<item_t> &items)
+{
+    if (depth == taskdepth) {
+        items.push_back(item_t{std::string(), true, qxybounds});
+        return;
+    }
+
+    if (items.empty() || items.back().task) {
+        items.push_back(item_t{std::string(), false, rootqxybounds});
+    }
+
+    tighten(qxybounds);
+    leaf_t record = {};
+    TextWriter writer;
+
+    if (generator.leaf(qxybounds, record)) {
+        writer.leaf(record);
+        items.back().text += writer.finish();
+        return;
+    }
+
+    const char kind = generator.choosesplit(qxybounds);
+    qxybounds_t lower;
+    qxybounds_t upper;
+    split(qxybounds, kind, lower, upper);
+    writer.split(kind);
+    items.back().text += writer.finish();
+    expand(generator, lower, depth + 1, items);
+    expand(generator, upper, depth + 1, items);
+}
+
+int main(int argc, char **argv)
+{
+    const char *ratestr = certificaterate;
+    const char *lowerboundstr = certificatelowerbound;
+    const char *filename = nullptr;
+    uint threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i = 1; i < argc; ++i) {
+        if ((std::string(argv[i]) == "--threads") && (i + 1 < argc)) {
+            if (!parsecount(argv[++i], maximumthreads, threads)) {
+                filename = nullptr;
+                break;
+            }
+
+            threads = (threads != 0) ? threads : std::max(1u, std::thread::hardware_concurrency());
+            continue;
+        }
+
+        if ((std::string(argv[i]) == "--rate") && (i + 1 < argc)) {
+            ratestr = argv[++i];
+            continue;
+        }
+
+        if ((std::string(argv[i]) == "--lowerbound") && (i + 1 < argc)) {
+            lowerboundstr = argv[++i];
+            continue;
+        }
+
+        if ((argv[i][0] != '-') && (i + 1 == argc)) {
+            filename = argv[i];
+            continue;
+        }
+
+        filename = nullptr;
+        break;
+    }
+
+    if (filename == nullptr) {
+        printf("usage: %s [--threads N] [--rate 0x0.hhh] [--lowerbound 0x0.hhh] output.txt\n", argv[0]);
+        return 1;
+    }
+
+    std::ofstream output(filename, std::ios::binary);
+
+    if (!output) {
+        printf("cannot write %s\n", filename);
+        return 1;
+    }
+
+    // the certificate starts with its parameters, so that the verifiers use them
+
+    TextWriter header;
+    header.parameters(parameters_t{ratestr, lowerboundstr});
+    output.write(header.finish().data(), std::streamsize(header.finish().size()));
+
+    Generator generator(ratestr, lowerboundstr);
+    std::vector<item_t> items;
+    expand(generator, rootqxybounds, 0, items);
+
+    // the tasks are taken in order by the threads, and the finished subtrees are written in order
+
+    std::mutex lock;
+    std::condition_variable changed;
+    std::vector<bool> done(items.size(), false);
+    std::atomic<size_t> next{0};
+
+    auto work = [&]() {
+        Generator taskgenerator(ratestr, lowerboundstr);
+
+        for (size_t index = next++; index < items.size(); index = next++) {
+            if (!items.at(index).task) {
+                continue;
+            }
+
+            TextWriter writer;
+            taskgenerator.generate(items.at(index).qxybounds, writer);
+            std::lock_guard<std::mutex> guard(lock);
+            items.at(index).text = writer.finish();
+            done.at(index) = true;
+            changed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> pool;
+
+    for (uint worker = 0; worker < threads; ++worker) {
+        pool.emplace_back(work);
+    }
+
+    for (size_t index = 0; index < items.size(); ++index) {
+        std::unique_lock<std::mutex> guard(lock);
+        changed.wait(guard, [&]() { return !items.at(index).task || done.at(index); });
+        std::string text;
+        text.swap(items.at(index).text);
+        guard.unlock();
+        output.write(text.data(), std::streamsize(text.size()));
+    }
+
+    for (std::thread &thread : pool) {
+        thread.join();
+    }
+
+    if (!output.flush()) {
+        printf("cannot write %s\n", filename);
+        return 1;
+    }
+
+    printf("finish\n");
+    return 0;
+}
@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../common/arguments.h"
+#include "certificate.h"
+#include "stream.h"
+#include "traversal.h"
+
+// replacement of generatewl.py: input.wl holds, for every leaf, the numerators of alpha and the betas (over
+// 2^leafexponent) and the extreme points of Q_X and Q_Y (over 2^fixedpointexponent), and mathematica.wl forms the
+// Q_XY of all pairs of extreme points itself; with --shards N, the leaves are distributed round-robin over N files
+// input-0.wl, ..., each of which starts with the definitions of mathematica.wl (read from the file, so that they
+// cannot diverge) and ends with Print["finish"], so that the shards can be verified by independent kernels (see
+// verifyshards.py)
+
+static const char *definitionsname = "mathematica.wl";
+static const std::string loadline = "<<\"input.wl\"\n";
+
+// the definitions of mathematica.wl, i.e., everything before its last line, which loads input.wl
+
+static bool readdefinitions(std::string &definitions)
+{
+    FILE *file = fopen(definitionsname, "rb");
+
+    if (file == nullptr) {
+        return false;
+    }
+
+    std::array<char, 4096> buffer;
+    size_t count = 0;
+
+    while ((count = fread(buffer.data(), 1, buffer.size(), file)) != 0) {
+        definitions.append(buffer.data(), count);
+    }
+
+    const bool valid = (ferror(file) == 0);
+    fclose(file);
+    const size_t load = definitions.rfind(loadline);
+
+    if (!valid || (load == std::string::npos) || ((load != 0) && (definitions.at(load - 1) != '\n')) || (load + loadline.size() != definitions.size())) {
+        return false;
+    }
+
+    definitions.resize(load);
+    return true;
+}
+
+// a parameter of the certificate (see certificate.h) as an exact number of Mathematica, e.g., 16^^07b28 / 2^20 for
+// 0x0.07b28, or an empty string if it is not in this form
+
+static std::string wlnumber(const std::string &parameter)
+{
+    const std::string prefix = "0x0.";
+    const std::string digits = parameter.substr(std::min(prefix.size(), parameter.size()));
+    const bool valid = (parameter.compare(0, prefix.size(), prefix) == 0) && !digits.empty() && (digits.find_first_not_of("0123456789abcdefABCDEF") == std::string::npos);
+    return valid ? ("16^^" + digits + " / 2^" + std::to_string(4 * digits.size())) : std::string();
+}
+
+static void printpoints(FILE *output, const extremepoints_t &points)
+{
+    const char *separator = "{";
+
+    for (const std::array<int32_t, 3> &point : points) {
+        fprintf(output, "%s{%d,%d,%d}", separator, point.at(0), point.at(1), point.at(2));
+        separator = ",";
+    }
+
+    fprintf(output, "}");
+}
+
+template <typename Format>
+static void generatewl(const Format &format, const std::vector<FILE *> &outputs)
+{
+    extremepoints_t qxextremepoints;
+    extremepoints_t qyextremepoints;
+    uint64_t leafs = 0;
+
+    walk(format, [&](const qxybounds_t &qxybounds, const leaf_t &leaf) {
+        FILE *output = outputs.at(leafs++ % outputs.size());
+        findextremepoints(qxybounds, 0, qxextremepoints);
+        findextremepoints(qxybounds, 3, qyextremepoints);
+        fprintf(output, "verify[%llu,\n{", static_cast<unsigned long long>(leaf.alpha));
+
+        for (uint i = 0; i < 9; ++i) {
+            fprintf(output, (i == 0) ? "%llu" : ",%llu", static_cast<unsigned long long>(leaf.beta.at(i)));
+        }
+
+        fprintf(output, "},\n");
+        printpoints(output, qxextremepoints);
+        fprintf(output, ",\n");
+        printpoints(output, qyextremepoints);
+        fprintf(output, "];\n\n");
+    });
+
+    for (FILE *output : outputs) {
+        fprintf(output, "Print[\"finish\"];\n");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint shards = 0;
+    std::vector<const char *> filenames;
+    std::string outputname = "input.wl";
+    bool usage = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if ((std::string(argv[i]) == "--shards") && (i + 1 < argc)) {
+            usage = usage || !parsecount(argv[++i], maximumshards, shards) || (shards == 0);
+            continue;
+        }
+
+        // the parts of the certificate (each possibly compressed) are followed by the output file, if any
+
+        const std::string name = argv[i];
+        usage = usage || (name[0] == '-');
+
+        if ((name.size() > 3) && (name.compare(name.size() - 3, 3, ".wl") == 0) && (i + 1 == argc)) {
+            outputname = name;
+        } else {
+            filenames.push_back(argv[i]);
+        }
+    }
+
+    if (usage) {
+        printf("usage: %s [--shards N] [input.txt | input.bin | part ...] [input.wl]\n", argv[0]);
+        return 1;
+    }
+
+    if (filenames.empty()) {
+        filenames.push_back("input.txt");
+    }
+
+    const StreamedInput input(filenames);
+
+    if (!input.reserved()) {
+        printf("cannot reserve %zu bytes of address space for the decompressed certificate\n", streamcapacity);
+        return 1;
+    }
+
+    if (!input.valid()) {
+        printf("cannot open %s\n", input.failedname());
+        return 1;
+    }
+
+    // the shards are named after the output file, e.g., input-0.wl, ... for input.wl
+
+    std::vector<std::string> outputnames;
+
+    if (shards == 0) {
+        outputnames.push_back(outputname);
+    } else {
+        const std::string stem = outputname.substr(0, outputname.rfind(".wl"));
+
+        for (uint shard = 0; shard < shards; ++shard) {
+            outputnames.push_back(stem + "-" + std::to_string(shard) + ".wl");
+        }
+    }
+
+    // the definitions in mathematica.wl are for the original certificate, so the parameters of another certificate
+    // replace them at the start of every output, before the leaves
+
+    const parameters_t parameters = certificateparameters(input);
+    std::string overrides;
+
+    if (!parameters.rate.empty()) {
+        const std::string rate = wlnumber(parameters.rate);
+        const std::string lowerbound = wlnumber(parameters.lowerbound);
+
+        if (rate.empty() || lowerbound.empty()) {
+            printf("cannot write rate %s and lower bound %s in Mathematica, please use 0x0.hhh\n", parameters.rate.c_str(), parameters.lowerbound.c_str());
+            return 1;
+        }
+
+        overrides = "rate = " + rate + ";\nlowerbound = " + lowerbound + ";\n\n";
+    }
+
+    std::string definitions;
+
+    if ((shards != 0) && !readdefinitions(definitions)) {
+        printf("cannot read the definitions of %s, which has to end with %s", definitionsname, loadline.c_str());
+        return 1;
+    }
+
+    std::vector<FILE *> outputs;
+
+    for (const std::string &name : outputnames) {
+        outputs.push_back(fopen(name.c_str(), "w"));
+
+        if (outputs.back() == nullptr) {
+            printf("cannot write %s\n", name.c_str());
+            return 1;
+        }
+
+        if (shards != 0) {
+            fputs(definitions.c_str(), outputs.back());
+        }
+
+        fputs(overrides.c_str(), outputs.back());
+    }
+
+    const bool binary = isbinary(input.data(), input.wait(binarymagic.size()));
+
+    if (input.mapped() && binary) {
+        generatewl(BinaryFormat(input.data(), input.size()), outputs);
+    } else if (input.mapped()) {
+        generatewl(TextFormat(input.data(), input.size()), outputs);
+    } else if (binary) {
+        generatewl(StreamedFormat<BinaryFormat>(input), outputs);
+    } else {
+        generatewl(StreamedFormat<TextFormat>(input), outputs);
+    }
+
+    for (size_t index = 0; index < outputs.size(); ++index) {
+        if ((ferror(outputs.at(index)) != 0) || (fclose(outputs.at(index)) != 0)) {
+            printf("cannot write %s\n", outputnames.at(index).c_str());
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -1,11 +1,28 @@
 import fractions
 import itertools
 
-def fractionfromhex(string):
+def numeratorfromhex(string):
     if (len(string) != 16) or (string[1] != '.'):
         raise RuntimeError('oops')
 
-    return fractions.Fraction(int(string[0] + string[2:], 16), 1 << 56)
+    return int(string[0] + string[2:], 16)
+
+def numeratorfromfraction(value):
+    value *= 1 << 29
+
+    if value.denominator != 1:
+        raise RuntimeError('oops')
+
+    return value.numerator
+
+def wlnumber(string):
+    # a parameter of the certificate as an exact number of Mathematica, as in generatewl.cpp
+    digits = string[4:]
+
+    if (not string.startswith('0x0.')) or (not digits) or any(c not in '0123456789abcdefABCDEF' for c in digits):
+        raise RuntimeError('cannot write {} in Mathematica, please use 0x0.hhh'.format(string))
+
+    return '16^^{} / 2^{}'.format(digits, 4 * len(digits))
 
 permutations = tuple(itertools.permutations(range(3)))
 
@@ -30,6 +47,20 @@ def computeextremepoints(lower, upper):
 
 infile = open('input.txt', 'r')
 outfile = open('input.wl', 'w')
+
+# the optional first line "p rate lowerbound" replaces the definitions in mathematica.wl before the leaves
+line = infile.readline()
+
+if line.startswith('p '):
+    tokens = line[2:].split()
+
+    if len(tokens) != 2:
+        raise RuntimeError('oops')
+
+    outfile.write('rate = {};\nlowerbound = {};\n\n'.format(wlnumber(tokens[0]), wlnumber(tokens[1])))
+else:
+    infile.seek(0)
+
 todo = [([fractions.Fraction(0)] * 6, [fractions.Fraction(1)] * 6)]
 
 while todo:
@@ -59,18 +90,18 @@ while todo:
         qyextremepoints = computeextremepoints(lower[3:], upper[3:])
         parts = list()
 
-        for qx in qxextremepoints:
-            for qy in qyextremepoints:
-                qxy = [qx[index // 3] * qy[index % 3] for index in range(9)]
-                parts.append(','.join(str(z) for z in qxy))
+        for points in (qxextremepoints, qyextremepoints):
+            parts.append('},{'.join(','.join(str(numeratorfromfraction(z)) for z in point) for point in points))
 
         outfile.write('verify[{},\n'
+                      '{{{}}},\n'
                       '{{{{{}}}}},\n'
                       '{{{{{}}}}}];\n'
                       '\n'
-                      .format(fractionfromhex(tokens[0]),
-                              '},\n{'.join(str(fractionfromhex(z)) for z in tokens[1:10]),
-                              '},\n{'.join(parts)))
+                      .format(numeratorfromhex(tokens[0]),
+                              ','.join(str(numeratorfromhex(z)) for z in tokens[1:10]),
+                              parts[0],
+                              parts[1]))
         continue
 
     splitindex = {'a\n': 0, 'b\n': 1, 'c\n': 2, 'd\n': 3, 'e\n': 4, 'f\n': 5}[line]
@@ -0,0 +1,238 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <cmath>
+#include <cstdlib>
+
+#include "../common/ddbackend.h"
+#include "../common/mpfibackend.h"
+#include "../common/mpfrbackend.h"
+#include "verifier.h"
+
+// estimate of alpha and betas for a box: a box becomes a leaf if alpha and betas can be found for which the
+// verification with double-double intervals succeeds, and then also with MPFI and MPFR at the precision of the
+// programs mpfi and mpfr (so that a leaf with a thin margin does not make them abort), otherwise it is split where the
+// estimated lower bounds of the two parts are best
+
+static const int generatorprecision = 68;
+static const uint alphasteps = 40;
+static const double minbeta = std::ldexp(1.0, -30);
+static const double maxbeta = 8.0;
+
+class Generator
+{
+  public:
+    Generator(const char *ratestr, const char *lowerboundstr);
+
+    void generate(qxybounds_t qxybounds, TextWriter &writer);
+    bool leaf(const qxybounds_t &qxybounds, leaf_t &leaf);
+    char choosesplit(const qxybounds_t &qxybounds);
+
+  private:
+    double estimate(const qxybounds_t &qxybounds, double alpha, std::array<double, 9> &beta);
+    double bestestimate(const qxybounds_t &qxybounds, double &alpha, std::array<double, 9> &beta);
+
+    double rate;
+    double lowerbound;
+    std::array<double, 9> pxy;
+    Verifier<DdBackend> verifier;
+    Verifier<MpfiBackend<generatorprecision>> mpfiverifier;
+    Verifier<MpfrBackend<generatorprecision>> mpfrverifier;
+    extremepoints_t qxextremepoints;
+    extremepoints_t qyextremepoints;
+    bool exactminimum = false; // of the last estimate
+    result_t result;
+};
+
+inline Generator::Generator(const char *ratestr, const char *lowerboundstr) : rate(strtod(ratestr, nullptr)), lowerbound(strtod(lowerboundstr, nullptr)), verifier(ratestr, lowerboundstr), mpfiverifier(ratestr, lowerboundstr), mpfrverifier(ratestr, lowerboundstr)
+{
+    for (uint x = 0; x < 3; ++x) {
+        for (uint y = 0; y < 3; ++y) {
+            pxy.at(3 * x + y) = double(pxynumerator(x, y)) / double(pxydenominator);
+        }
+    }
+}
+
+inline double Generator::estimate(const qxybounds_t &qxybounds, double alpha, std::array<double, 9> &beta)
+{
+    // for a single Q_XY, the betas beta(x, y) = c Q_XY(x, y)^\alpha - P_XY(x, y)^\alpha give the largest value,
+    // independent of c >= \max P_XY^\alpha / Q_XY^\alpha; the box is represented by the center of its bounds, and
+    // c is limited (with small betas replaced by minbeta) so that the betas stay below maxbeta, and every beta is
+    // positive so that D is not zero
+
+    std::array<double, 3> qx = {};
+    std::array<double, 3> qy = {};
+
+    for (uint i = 0; i < 3; ++i) {
+        qx.at(i) = 0.5 * (double(qxybounds.lower.at(i)) + double(qxybounds.upper.at(i)));
+        qy.at(i) = 0.5 * (double(qxybounds.lower.at(3 + i)) + double(qxybounds.upper.at(3 + i)));
+    }
+
+    const double qxsum = qx.at(0) + qx.at(1) + qx.at(2);
+    const double qysum = qy.at(0) + qy.at(1) + qy.at(2);
+    double c = 0.0;
+
+    for (uint x = 0; x < 3; ++x) {
+        for (uint y = 0; y < 3; ++y) {
+            const double qxy = (qx.at(x) / qxsum) * (qy.at(y) / qysum);
+            beta.at(3 * x + y) = std::pow(qxy, alpha);
+            c = std::max(c, std::pow(pxy.at(3 * x + y), alpha) / beta.at(3 * x + y));
+        }
+    }
+
+    c = std::min(c, maxbeta);
+    double pterm = 0.0;
+
+    for (uint i = 0; i < 9; ++i) {
+        beta.at(i) = std::max(minbeta, c * beta.at(i) - std::pow(pxy.at(i), alpha));
+        pterm += std::pow(std::pow(pxy.at(i), alpha) + beta.at(i), 1.0 / alpha);
+    }
+
+    pterm = std::pow(pterm, alpha);
+
+    // D over all pairs of extreme points, as in the verification; if both extreme points are point masses, the value
+    // is a single beta, and the verification needs the minimum to be clearly below such an exact value
+
+    findextremepoints(qxybounds, 0, qxextremepoints);
+    findextremepoints(qxybounds, 3, qyextremepoints);
+    double qxybetamin = HUGE_VAL;
+    double exactmin = HUGE_VAL;
+
+    for (const std::array<int32_t, 3> &qxpoint : qxextremepoints) {
+        for (const std::array<int32_t, 3> &qypoint : qyextremepoints) {
+            double value = 0.0;
+
+            for (uint x = 0; x < 3; ++x) {
+                for (uint y = 0; y < 3; ++y) {
+                    const double qxy = std::ldexp(double(qxpoint.at(x)), -fixedpointexponent) * std::ldexp(double(qypoint.at(y)), -fixedpointexponent);
+                    value += (qxy > 0.0) ? (std::pow(qxy, 1.0 - alpha) * beta.at(3 * x + y)) : 0.0;
+                }
+            }
+
+            const bool qxexact = (*std::max_element(qxpoint.begin(), qxpoint.end()) == fixedpointone);
+            const bool qyexact = (*std::max_element(qypoint.begin(), qypoint.end()) == fixedpointone);
+            qxybetamin = std::min(qxybetamin, value);
+            exactmin = (qxexact && qyexact) ? std::min(exactmin, value) : exactmin;
+        }
+    }
+
+    exactminimum = (exactmin <= qxybetamin * (1.0 + 1e-12));
+
+    // a difference close to the rounding errors of this estimate is not accepted
+
+    if (!(pterm - qxybetamin > 1e-9 * pterm)) {
+        return -HUGE_VAL;
+    }
+
+    return -(std::log(pterm - qxybetamin) + (1.0 - alpha) * rate) / alpha;
+}
+
+inline double Generator::bestestimate(const qxybounds_t &qxybounds, double &alpha, std::array<double, 9> &beta)
+{
+    // golden-section search for alpha
+
+    static const double ratio = 0.5 * (std::sqrt(5.0) - 1.0);
+    double left = 0.01;
+    double right = 0.99;
+    double middleleft = right - ratio * (right - left);
+    double middleright = left + ratio * (right - left);
+    double valueleft = estimate(qxybounds, middleleft, beta);
+    double valueright = estimate(qxybounds, middleright, beta);
+
+    for (uint step = 0; step < alphasteps; ++step) {
+        if (valueleft < valueright) {
+            left = middleleft;
+            middleleft = middleright;
+            valueleft = valueright;
+            middleright = left + ratio * (right - left);
+            valueright = estimate(qxybounds, middleright, beta);
+        } else {
+            right = middleright;
+            middleright = middleleft;
+            valueright = valueleft;
+            middleleft = right - ratio * (right - left);
+            valueleft = estimate(qxybounds, middleleft, beta);
+        }
+    }
+
+    alpha = 0.5 * (left + right);
+    return estimate(qxybounds, alpha, beta);
+}
+
+inline bool Generator::leaf(const qxybounds_t &qxybounds, leaf_t &leaf)
+{
+    double alpha = 0.0;
+    std::array<double, 9> beta = {};
+
+    if ((bestestimate(qxybounds, alpha, beta) <= lowerbound) || exactminimum) {
+        return false;
+    }
+
+    leaf.alpha = uint64_t(std::ldexp(alpha, leafexponent));
+
+    for (uint i = 0; i < 9; ++i) {
+        CHECK(beta.at(i) <= maxbeta);
+        leaf.beta.at(i) = uint64_t(std::ldexp(beta.at(i), leafexponent));
+    }
+
+    return verifier.verify(qxybounds, leaf, result) && mpfiverifier.verify(qxybounds, leaf, result) && mpfrverifier.verify(qxybounds, leaf, result);
+}
+
+inline char Generator::choosesplit(const qxybounds_t &qxybounds)
+{
+    // the split for which the worse of the two parts has the best estimate
+
+    double best = -HUGE_VAL;
+    char bestkind = 0;
+
+    for (uint j = 0; j < 6; ++j) {
+        if (((qxybounds.lower.at(j) % 2) != 0) || ((qxybounds.upper.at(j) % 2) != 0)) {
+            continue;
+        }
+
+        qxybounds_t lower;
+        qxybounds_t upper;
+        split(qxybounds, char('a' + j), lower, upper);
+        tightenunchecked(lower);
+        tightenunchecked(upper);
+
+        if (!valid(lower) || !valid(upper)) {
+            continue;
+        }
+
+        double alpha = 0.0;
+        std::array<double, 9> beta = {};
+        const double value = std::min(bestestimate(lower, alpha, beta), bestestimate(upper, alpha, beta));
+
+        if ((bestkind == 0) || (value > best)) {
+            best = value;
+            bestkind = char('a' + j);
+        }
+    }
+
+    CHECK(bestkind != 0);
+    return bestkind;
+}
+
+inline void Generator::generate(qxybounds_t qxybounds, TextWriter &writer)
+{
+    // the same order as the traversal: tighten once, then a leaf or the lower part before the upper part
+
+    tighten(qxybounds);
+    leaf_t record = {};
+
+    if (leaf(qxybounds, record)) {
+        writer.leaf(record);
+        return;
+    }
+
+    const char kind = choosesplit(qxybounds);
+    qxybounds_t lower;
+    qxybounds_t upper;
+    split(qxybounds, kind, lower, upper);
+    writer.split(kind);
+    generate(lower, writer);
+    generate(upper, writer);
+}
+
+#endif
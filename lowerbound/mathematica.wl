@@ -7,7 +7,12 @@ lowerbound = 58488010525784883 / 2^56;
 
 verify[alpha_, beta_, qxy_] := Print[-(Log[Norm[Flatten[(pxy ^ alpha) + beta], 1 / alpha] - Min[(qxy ^ (1 - alpha)) . beta]] + (1 - alpha) * rate) / alpha >= lowerbound];
 
+(* input.wl holds the numerators of alpha and the betas (over 2^56) and the extreme points of Q_X and Q_Y (over 2^29) *)
+verify[alpha_, beta_, qx_, qy_] := verify[alpha / 2^56, Transpose[{beta / 2^56}], Flatten[TensorProduct @@ #] & /@ Tuples[{qx, qy} / 2^29]];
+
 Print[Min[pxy] > 0];
 Print[Total[pxy, 2] == 1];
 
-If[10*29^(7151557967478901/9007199254740992) < 145, <<"input.wl", Print["please use Mathematica >= 12.0.0"]];
+If[!(10*29^(7151557967478901/9007199254740992) < 145), Print["please use Mathematica >= 12.0.0"]; Exit[1]];
+
+<<"input.wl"
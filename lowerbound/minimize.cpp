@@ -0,0 +1,180 @@
+#include <cstdio>
+
+#include "generator.h"
+
+// offline pass that makes a certificate smaller: bottom-up, a split whose two parts are leaves (possibly after
+// merging) is verified directly with the alpha and betas of Generator, and replaced by a single leaf if the
+// verification succeeds with double-double intervals, MPFI and MPFR (see Generator::leaf); the output starts with the
+// parameters for which it was verified
+
+template <typename Format>
+class Minimizer
+{
+  public:
+    Minimizer(const Format &format, const parameters_t &parameters, FILE *output);
+
+    size_t minimize(size_t offset, qxybounds_t qxybounds, bool &isleaf, leaf_t &leaf);
+    void finish();
+
+    uint64_t splits = 0;
+    uint64_t merged = 0;
+    uint64_t leafs = 0;
+
+  private:
+    bool merge(const qxybounds_t &qxybounds, leaf_t &leaf);
+    void flush();
+
+    const Format &format;
+    FILE *output;
+    Generator generator;
+
+    // the nodes that may still be merged into a leaf, i.e., the split lines on the path from the last node that
+    // cannot be merged and the leaves to their left; everything before them is written
+    TextWriter pending;
+};
+
+template <typename Format>
+Minimizer<Format>::Minimizer(const Format &format, const parameters_t &parameters, FILE *output) : format(format), output(output), generator(parameters.rate.c_str(), parameters.lowerbound.c_str())
+{
+    pending.parameters(parameters);
+    flush();
+}
+
+// returns the offset after the subtree and whether it is (now) a single leaf; if not, the subtree is written
+
+template <typename Format>
+size_t Minimizer<Format>::minimize(size_t offset, qxybounds_t qxybounds, bool &isleaf, leaf_t &leaf)
+{
+    tighten(qxybounds);
+    const char kind = format.kind(offset);
+
+    if (kind == 'v') {
+        format.record(offset, leaf);
+        isleaf = true;
+        ++leafs;
+        return format.next(offset);
+    }
+
+    ++splits;
+    const size_t mark = pending.size();
+    pending.split(kind);
+
+    qxybounds_t lower;
+    qxybounds_t upper;
+    split(qxybounds, kind, lower, upper);
+    bool lowerleaf = false;
+    bool upperleaf = false;
+    leaf_t lowerrecord = {};
+    leaf_t upperrecord = {};
+    offset = minimize(format.next(offset), lower, lowerleaf, lowerrecord);
+
+    if (lowerleaf) {
+        pending.leaf(lowerrecord);
+    }
+
+    offset = minimize(offset, upper, upperleaf, upperrecord);
+
+    // if both parts are leaves, nothing below has been written, and the split and the lower leaf are the end of pending
+
+    if (lowerleaf && upperleaf && merge(qxybounds, leaf)) {
+        pending.truncate(mark);
+        isleaf = true;
+        ++merged;
+        return offset;
+    }
+
+    if (upperleaf) {
+        pending.leaf(upperrecord);
+    }
+
+    flush();
+    isleaf = false;
+    return offset;
+}
+
+template <typename Format>
+bool Minimizer<Format>::merge(const qxybounds_t &qxybounds, leaf_t &leaf)
+{
+    return generator.leaf(qxybounds, leaf);
+}
+
+template <typename Format>
+void Minimizer<Format>::flush()
+{
+    const std::string &text = pending.finish();
+    CHECK(fwrite(text.data(), 1, text.size(), output) == text.size());
+    pending.truncate(0);
+}
+
+template <typename Format>
+void Minimizer<Format>::finish()
+{
+    bool isleaf = false;
+    leaf_t leaf = {};
+    minimize(format.begin(), rootqxybounds, isleaf, leaf);
+
+    if (isleaf) {
+        pending.leaf(leaf);
+        flush();
+    }
+
+    CHECK(fflush(output) == 0);
+    fprintf(stderr, "%llu of %llu splits merged, %llu leaves -> %llu leaves\n", static_cast<unsigned long long>(merged), static_cast<unsigned long long>(splits), static_cast<unsigned long long>(leafs), static_cast<unsigned long long>(leafs - merged));
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<const char *> filenames;
+    parameters_t options;
+    bool usage = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if ((std::string(argv[i]) == "--rate") && (i + 1 < argc)) {
+            options.rate = argv[++i];
+        } else if ((std::string(argv[i]) == "--lowerbound") && (i + 1 < argc)) {
+            options.lowerbound = argv[++i];
+        } else {
+            filenames.push_back(argv[i]);
+            usage = usage || (argv[i][0] == '-');
+        }
+    }
+
+    if (usage || (filenames.size() != 2)) {
+        printf("usage: %s [--rate 0x0.hhh] [--lowerbound 0x0.hhh] input.txt|input.bin output.txt\n", argv[0]);
+        return 1;
+    }
+
+    const MappedFile input(filenames.at(0));
+
+    if (!input.valid()) {
+        printf("cannot open %s\n", filenames.at(0));
+        return 1;
+    }
+
+    const bool binary = isbinary(input.data(), input.size());
+    parameters_t parameters;
+
+    if (!resolveparameters(binary ? BinaryFormat(input.data(), input.size()).parameters() : TextFormat(input.data(), input.size()).parameters(), options, parameters)) {
+        printf("the certificate is for rate %s and lower bound %s\n", parameters.rate.c_str(), parameters.lowerbound.c_str());
+        return 1;
+    }
+
+    FILE *output = fopen(filenames.at(1), "wb");
+
+    if (output == nullptr) {
+        printf("cannot write %s\n", filenames.at(1));
+        return 1;
+    }
+
+    if (binary) {
+        const BinaryFormat format(input.data(), input.size());
+        Minimizer<BinaryFormat>(format, parameters, output).finish();
+    } else {
+        const TextFormat format(input.data(), input.size());
+        Minimizer<TextFormat>(format, parameters, output).finish();
+    }
+
+    CHECK(fclose(output) == 0);
+    printf("finish\n");
+    return 0;
+}
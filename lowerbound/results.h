@@ -0,0 +1,170 @@
+#ifndef RESULTS_H
+#define RESULTS_H
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+#include "../common/check.h"
+
+// the result of a verified leaf: its lower bound rounded down to 63 bits, as mantissa * 2^exponent (see backend.h),
+// and as printed ("%.20RDf" of the full lower bound), which is left empty with --quiet
+
+struct result_t {
+    int64_t mantissa;
+    int64_t exponent;
+    std::array<char, 32> text;
+};
+
+// the results in the order of the certificate: every result is printed, or with --quiet only the smallest value, its
+// leaf and a digest of all values are kept; with --log FILE, the 63-bit lower bounds are also written to FILE, i.e.,
+// the magic string followed by mantissa and exponent as 64-bit little-endian integers per leaf (only the lower end of
+// the enclosure and rounded, as the backends differ in their enclosures and MPFR has no upper end), and the digest is
+// the FNV-1a hash of these 16 bytes per leaf
+
+static const std::string resultsmagic = "qxylb63\n";
+static const size_t resultsbuffersize = size_t(1) << 20;
+
+static bool resultsquiet = false;
+static FILE *resultslog = nullptr;
+static std::vector<char> resultsbuffer;
+static uint64_t resultscount = 0;
+static uint64_t resultsdigest = UINT64_C(14695981039346656037); // FNV-1a offset basis
+static result_t resultsminimum = {};
+static uint64_t resultsminimumleaf = 0;
+
+static inline bool resultsopen(const char *filename)
+{
+    resultslog = fopen(filename, "wb");
+    resultsbuffer.reserve(resultsbuffersize);
+    resultsbuffer.assign(resultsmagic.begin(), resultsmagic.end());
+    return resultslog != nullptr;
+}
+
+static inline bool resultless(const result_t &a, const result_t &b)
+{
+    // exact, since a nonzero mantissa has its highest bit at 2^62
+
+    const int signa = (a.mantissa > 0) - (a.mantissa < 0);
+    const int signb = (b.mantissa > 0) - (b.mantissa < 0);
+
+    if ((signa != signb) || (signa == 0)) {
+        return signa < signb;
+    }
+
+    if (a.exponent != b.exponent) {
+        return (a.exponent < b.exponent) == (signa > 0);
+    }
+
+    return a.mantissa < b.mantissa;
+}
+
+static inline void resultsadd(const result_t &result)
+{
+    if (!resultsquiet) {
+        printf("%s\n", result.text.data());
+    }
+
+    if ((resultscount == 0) || resultless(result, resultsminimum)) {
+        resultsminimum = result;
+        resultsminimumleaf = resultscount;
+    }
+
+    ++resultscount;
+
+    for (const int64_t value : {result.mantissa, result.exponent}) {
+        for (uint i = 0; i < 8; ++i) {
+            const uint8_t byte = uint8_t(uint64_t(value) >> (8 * i));
+            resultsdigest = (resultsdigest ^ byte) * UINT64_C(1099511628211);
+
+            if (resultslog != nullptr) {
+                resultsbuffer.push_back(char(byte));
+            }
+        }
+    }
+
+    // the log is written in large blocks
+
+    if (resultsbuffer.size() >= resultsbuffersize) {
+        CHECK(fwrite(resultsbuffer.data(), 1, resultsbuffer.size(), resultslog) == resultsbuffer.size());
+        resultsbuffer.clear();
+    }
+}
+
+// with --rates FILE: further pairs of a rate and a lower bound, for which every verifier computes the values of the
+// leaves as well (from the same D and P-term); the totals of all verifiers are the smallest value per rate, which is
+// the largest lower bound that the certificate establishes for the rate, and the number of leaves whose value does not
+// exceed the lower bound of the pair
+
+struct rateresult_t {
+    std::string rate;
+    std::string lowerbound;
+    uint64_t leafs = 0;
+    uint64_t failures = 0;
+    result_t minimum = {};
+};
+
+static std::vector<rateresult_t> resultsrates;
+static std::mutex resultsrateslock;
+
+static inline bool resultsreadrates(const char *filename)
+{
+    // whitespace-separated pairs "rate lowerbound", e.g., "0x0.07b28 0x0.cfca8923023b33"; a longer token than fits into
+    // the arrays would be split, so the file is not valid (the numbers are checked by the verifier, see invalidrate)
+
+    FILE *file = fopen(filename, "r");
+
+    if (file == nullptr) {
+        return false;
+    }
+
+    std::array<char, 256> rate;
+    std::array<char, 256> lowerbound;
+    int count = 0;
+    bool truncated = false;
+
+    while ((count = fscanf(file, "%255s %255s", rate.data(), lowerbound.data())) == 2) {
+        truncated = truncated || (strlen(rate.data()) == rate.size() - 1) || (strlen(lowerbound.data()) == lowerbound.size() - 1);
+        resultsrates.emplace_back();
+        resultsrates.back().rate = rate.data();
+        resultsrates.back().lowerbound = lowerbound.data();
+    }
+
+    const bool valid = (count == EOF) && (ferror(file) == 0) && !truncated && !resultsrates.empty();
+    fclose(file);
+    return valid;
+}
+
+static inline void resultsmergerate(rateresult_t &total, uint64_t leafs, uint64_t failures, const result_t &minimum)
+{
+    if (leafs == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(resultsrateslock);
+
+    if ((total.leafs == 0) || resultless(minimum, total.minimum)) {
+        total.minimum = minimum;
+    }
+
+    total.leafs += leafs;
+    total.failures += failures;
+}
+
+static inline bool resultsclose()
+{
+    if (resultslog == nullptr) {
+        return true;
+    }
+
+    const bool written = (fwrite(resultsbuffer.data(), 1, resultsbuffer.size(), resultslog) == resultsbuffer.size());
+    resultsbuffer.clear();
+    return (fclose(resultslog) == 0) && written;
+}
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <sys/types.h>
+
+// optional statistics (--stats): every thread counts and times its own work and adds it to the totals when it is
+// done; with statistics disabled, every hook below only tests a flag
+
+enum phase_t { parsing, tightening, extremepoints, pterm, finalcheck };
+
+static const std::array<const char *, 5> phasenames = {{"parsing", "tightening", "extremepoints", "pterm", "finalcheck"}};
+static const double progressseconds = 10.0;
+
+struct stats_t {
+    uint64_t leafs = 0;
+    uint64_t splits = 0;
+    uint64_t maxdepth = 0;      // of the stack of the serial traversal
+    uint64_t extremepoints = 0; // pairs of extreme points Q_X, Q_Y evaluated for D
+    uint64_t prunedpairs = 0;   // pairs skipped since they cannot attain the minimum
+    uint64_t logs = 0;
+    uint64_t exps = 0;
+    std::array<uint64_t, 5> nanoseconds = {};
+};
+
+static bool statsenabled = false;
+static stats_t totalstats;
+static std::mutex totalstatslock;
+static std::atomic<uint64_t> progressleafs{0};
+static std::chrono::steady_clock::time_point statsbegin;
+static std::chrono::steady_clock::time_point progressprinted;
+static thread_local stats_t threadstats;
+static thread_local std::chrono::steady_clock::time_point threadlap;
+
+static inline uint64_t nanosecondssince(std::chrono::steady_clock::time_point &last)
+{
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    const uint64_t nanoseconds = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count());
+    last = now;
+    return nanoseconds;
+}
+
+static inline void enablestats()
+{
+    statsenabled = true;
+    statsbegin = std::chrono::steady_clock::now();
+    progressprinted = statsbegin;
+}
+
+// start timing the current thread, and attribute the time since the last call to a phase
+
+static inline void statsstart()
+{
+    if (statsenabled) {
+        threadlap = std::chrono::steady_clock::now();
+    }
+}
+
+static inline void statslap(phase_t phase)
+{
+    if (statsenabled) {
+        threadstats.nanoseconds.at(phase) += nanosecondssince(threadlap);
+    }
+}
+
+static inline void statsmerge()
+{
+    if (!statsenabled) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(totalstatslock);
+    totalstats.leafs += threadstats.leafs;
+    totalstats.splits += threadstats.splits;
+    totalstats.maxdepth = std::max(totalstats.maxdepth, threadstats.maxdepth);
+    totalstats.extremepoints += threadstats.extremepoints;
+    totalstats.prunedpairs += threadstats.prunedpairs;
+    totalstats.logs += threadstats.logs;
+    totalstats.exps += threadstats.exps;
+
+    for (uint i = 0; i < phasenames.size(); ++i) {
+        totalstats.nanoseconds.at(i) += threadstats.nanoseconds.at(i);
+    }
+
+    threadstats = stats_t();
+}
+
+static inline void statssplit(size_t depth)
+{
+    if (statsenabled) {
+        ++threadstats.splits;
+        threadstats.maxdepth = std::max(threadstats.maxdepth, uint64_t(depth));
+    }
+}
+
+// count a leaf, and let the first thread print a progress line every few seconds, where fraction is the part of the
+// certificate that is done
+
+static inline void statsleaf(bool progress, double fraction)
+{
+    if (!statsenabled) {
+        return;
+    }
+
+    ++threadstats.leafs;
+    const uint64_t leafs = ++progressleafs;
+
+    if (!progress || (std::chrono::duration<double>(std::chrono::steady_clock::now() - progressprinted).count() < progressseconds)) {
+        return;
+    }
+
+    progressprinted = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(progressprinted - statsbegin).count();
+    const double eta = (fraction > 0.0) ? (seconds * (1.0 - fraction) / fraction) : 0.0;
+    fprintf(stderr, "progress: %llu leaves, %.0f leaves/s, %.1f%%, eta %.0f s\n", static_cast<unsigned long long>(leafs), double(leafs) / seconds, 100.0 * fraction, eta);
+}
+
+static inline void printstats(FILE *file)
+{
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - statsbegin).count();
+    const stats_t &stats = totalstats;
+
+    fprintf(file, "{\n  \"seconds\": %.3f,\n  \"leafs\": %llu,\n  \"splits\": %llu,\n  \"maxdepth\": %llu,\n", seconds, static_cast<unsigned long long>(stats.leafs), static_cast<unsigned long long>(stats.splits), static_cast<unsigned long long>(stats.maxdepth));
+    fprintf(file, "  \"extremepoints\": %llu,\n  \"extremepointsperleaf\": %.3f,\n", static_cast<unsigned long long>(stats.extremepoints), (stats.leafs != 0) ? (double(stats.extremepoints) / double(stats.leafs)) : 0.0);
+    fprintf(file, "  \"prunedpairs\": %llu,\n  \"prunedpairsperleaf\": %.3f,\n", static_cast<unsigned long long>(stats.prunedpairs), (stats.leafs != 0) ? (double(stats.prunedpairs) / double(stats.leafs)) : 0.0);
+    fprintf(file, "  \"logs\": %llu,\n  \"exps\": %llu,\n", static_cast<unsigned long long>(stats.logs), static_cast<unsigned long long>(stats.exps));
+    fprintf(file, "  \"leafspersecond\": %.1f,\n  \"phaseseconds\": {", (seconds > 0.0) ? (double(stats.leafs) / seconds) : 0.0);
+
+    for (uint i = 0; i < phasenames.size(); ++i) {
+        fprintf(file, "%s\"%s\": %.3f", (i != 0) ? ", " : "", phasenames.at(i), 1e-9 * double(stats.nanoseconds.at(i)));
+    }
+
+    fprintf(file, "}\n}\n");
+}
+
+#endif
@@ -0,0 +1,315 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <lzma.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/mman.h>
+#include <thread>
+#include <vector>
+#include <zlib.h>
+
+#include "certificate.h"
+
+// input of a certificate from one or more parts (e.g., inputA.txt.xz inputB.txt.xz inputC.txt.xz), read in order as
+// one stream, where every part may be plain, gzip- or xz-compressed (detected by its first bytes); a single plain part
+// is mapped as before, and otherwise a thread decompresses the parts into memory while the traversal already reads
+// the beginning (see StreamedFormat)
+
+static const std::string gzipmagic = "\x1f\x8b";
+static const std::string xzmagic = std::string("\xfd" "7zXZ\0", 6);
+static const size_t streamchunk = size_t(1) << 20;
+static const size_t streamcapacity = size_t(1) << 40; // address space reserved for the decompressed stream
+
+class StreamedInput
+{
+  public:
+    explicit StreamedInput(const std::vector<const char *> &filenames);
+    ~StreamedInput();
+
+    bool valid() const { return (failed == nullptr) && !unreserved; }
+    const char *failedname() const { return failed; } // the first part that could not be opened, if any
+    bool reserved() const { return !unreserved; }     // false if the address space for the stream is not available
+    bool mapped() const { return mapping != nullptr; }
+    const char *data() const { return address; }
+    size_t size() const { return wait(SIZE_MAX); }
+    size_t filesize() const { return filesizes; } // 0 if a part is not a regular file, e.g., a pipe
+    size_t wait(size_t end) const;
+
+  private:
+    StreamedInput(const StreamedInput &) = delete;
+    StreamedInput &operator=(const StreamedInput &) = delete;
+
+    void decompress();
+    void plain(FILE *file, const std::string &start);
+    void gzip(FILE *file, const std::string &start);
+    void xz(FILE *file, const std::string &start);
+    char *reserve(size_t count);
+    void publish(size_t count);
+
+    std::vector<FILE *> files;
+    std::string prefix; // the first bytes of the first part, which are not read again, as it might be a pipe
+    const char *failed = nullptr;
+    bool unreserved = false;
+    std::unique_ptr<MappedFile> mapping;
+    const char *address = nullptr;
+    char *region = nullptr; // the decompressed stream, unless mapped
+    size_t filesizes = 0;
+    size_t written = 0; // only used by the decompression thread
+    std::atomic<size_t> available{0};
+    std::atomic<bool> finished{false};
+    mutable std::mutex lock;
+    mutable std::condition_variable changed;
+    std::thread decompressor;
+};
+
+static inline bool iscompressed(const std::string &start)
+{
+    return (start.compare(0, gzipmagic.size(), gzipmagic) == 0) || (start.compare(0, xzmagic.size(), xzmagic) == 0);
+}
+
+inline StreamedInput::StreamedInput(const std::vector<const char *> &filenames)
+{
+    // open every part first, so that a missing part is reported before anything is verified; the size of a part
+    // that cannot seek is unknown
+
+    bool seekable = true;
+
+    for (const char *filename : filenames) {
+        files.push_back(fopen(filename, "rb"));
+
+        if (files.back() == nullptr) {
+            failed = filename;
+            return;
+        }
+
+        const long end = (fseek(files.back(), 0, SEEK_END) == 0) ? ftell(files.back()) : -1;
+        seekable = seekable && (end >= 0);
+
+        if (end >= 0) {
+            filesizes += size_t(end);
+            rewind(files.back());
+        }
+    }
+
+    filesizes = seekable ? filesizes : 0;
+    prefix.resize(xzmagic.size());
+    prefix.resize(fread(&prefix.at(0), 1, prefix.size(), files.at(0)));
+
+    if ((files.size() == 1) && seekable && !iscompressed(prefix)) {
+        mapping.reset(new MappedFile(filenames.at(0)));
+
+        if (!mapping->valid()) {
+            failed = filenames.at(0);
+            return;
+        }
+
+        address = mapping->data();
+        available = mapping->size();
+        finished = true;
+        return;
+    }
+
+    // the region is only backed by memory as far as it is written
+
+    void *reservation = mmap(nullptr, streamcapacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    if (reservation == MAP_FAILED) {
+        unreserved = true;
+        return;
+    }
+
+    region = static_cast<char *>(reservation);
+    address = region;
+    decompressor = std::thread(&StreamedInput::decompress, this);
+}
+
+inline StreamedInput::~StreamedInput()
+{
+    if (decompressor.joinable()) {
+        decompressor.join();
+    }
+
+    for (FILE *file : files) {
+        if (file != nullptr) {
+            fclose(file);
+        }
+    }
+
+    if (region != nullptr) {
+        munmap(region, streamcapacity);
+    }
+}
+
+inline size_t StreamedInput::wait(size_t end) const
+{
+    // the number of bytes available, which is at least end unless the stream is shorter
+
+    if ((available.load() >= end) || finished.load()) {
+        return available.load();
+    }
+
+    std::unique_lock<std::mutex> guard(lock);
+    changed.wait(guard, [&]() { return (available.load() >= end) || finished.load(); });
+    return available.load();
+}
+
+inline void StreamedInput::decompress()
+{
+    for (FILE *file : files) {
+        std::string start = prefix;
+
+        if (file != files.at(0)) {
+            start.assign(xzmagic.size(), '\0');
+            start.resize(fread(&start.at(0), 1, start.size(), file));
+        }
+
+        if (start.compare(0, gzipmagic.size(), gzipmagic) == 0) {
+            gzip(file, start);
+        } else if (start.compare(0, xzmagic.size(), xzmagic) == 0) {
+            xz(file, start);
+        } else {
+            plain(file, start);
+        }
+
+        CHECK(ferror(file) == 0);
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+    finished = true;
+    changed.notify_all();
+}
+
+inline char *StreamedInput::reserve(size_t count)
+{
+    CHECK(written + count <= streamcapacity);
+    return region + written;
+}
+
+inline void StreamedInput::publish(size_t count)
+{
+    written += count;
+    std::lock_guard<std::mutex> guard(lock);
+    available = written;
+    changed.notify_all();
+}
+
+inline void StreamedInput::plain(FILE *file, const std::string &start)
+{
+    memcpy(reserve(start.size()), start.data(), start.size());
+    publish(start.size());
+
+    while (!feof(file) && (ferror(file) == 0)) {
+        publish(fread(reserve(streamchunk), 1, streamchunk, file));
+    }
+}
+
+inline void StreamedInput::gzip(FILE *file, const std::string &start)
+{
+    // a part may consist of several gzip members, e.g., from cat inputA.txt.gz inputB.txt.gz
+
+    std::vector<unsigned char> input(streamchunk);
+    memcpy(input.data(), start.data(), start.size());
+    z_stream stream = {};
+    CHECK(inflateInit2(&stream, 16 + MAX_WBITS) == Z_OK);
+    stream.next_in = input.data();
+    stream.avail_in = uInt(start.size());
+    bool flushed = true; // whether the last call left room in the output, i.e., has no more output pending
+
+    while (true) {
+        if ((stream.avail_in == 0) && !feof(file)) {
+            stream.next_in = input.data();
+            stream.avail_in = uInt(fread(input.data(), 1, input.size(), file));
+            CHECK(ferror(file) == 0);
+        }
+
+        if ((stream.avail_in == 0) && feof(file) && flushed) {
+            break;
+        }
+
+        stream.next_out = reinterpret_cast<unsigned char *>(reserve(streamchunk));
+        stream.avail_out = uInt(streamchunk);
+        const int status = inflate(&stream, Z_NO_FLUSH);
+        CHECK((status == Z_OK) || (status == Z_STREAM_END) || ((status == Z_BUF_ERROR) && (stream.avail_in == 0)));
+        flushed = (stream.avail_out != 0);
+        publish(streamchunk - stream.avail_out);
+
+        if (status == Z_STREAM_END) {
+            CHECK(inflateReset(&stream) == Z_OK);
+        }
+    }
+
+    // the last member must be complete
+
+    CHECK(stream.total_in == 0);
+    inflateEnd(&stream);
+}
+
+inline void StreamedInput::xz(FILE *file, const std::string &start)
+{
+    std::vector<uint8_t> input(streamchunk);
+    memcpy(input.data(), start.data(), start.size());
+    lzma_stream stream = LZMA_STREAM_INIT;
+    CHECK(lzma_stream_decoder(&stream, UINT64_MAX, LZMA_CONCATENATED) == LZMA_OK);
+    stream.next_in = input.data();
+    stream.avail_in = start.size();
+    lzma_ret status = LZMA_OK;
+
+    while (status != LZMA_STREAM_END) {
+        if ((stream.avail_in == 0) && !feof(file)) {
+            stream.next_in = input.data();
+            stream.avail_in = fread(input.data(), 1, input.size(), file);
+            CHECK(ferror(file) == 0);
+        }
+
+        stream.next_out = reinterpret_cast<uint8_t *>(reserve(streamchunk));
+        stream.avail_out = streamchunk;
+        status = lzma_code(&stream, feof(file) ? LZMA_FINISH : LZMA_RUN);
+        CHECK((status == LZMA_OK) || (status == LZMA_STREAM_END));
+        publish(streamchunk - stream.avail_out);
+    }
+
+    lzma_end(&stream);
+}
+
+// the parameters in the header of the certificate, if any (see certificate.h)
+
+static inline parameters_t certificateparameters(const StreamedInput &input)
+{
+    const size_t available = input.wait(binarymagic.size() + 12 + maxparameterssize);
+    return isbinary(input.data(), available) ? BinaryFormat(input.data(), available).parameters() : TextFormat(input.data(), available).parameters();
+}
+
+// a format (TextFormat or BinaryFormat) over a stream that is still growing: every access waits until the bytes of
+// the node are available (or the stream has ended) and then reads them through the format over the available part,
+// so that its checks apply as before; end is the part that is available so far
+
+template <typename Format>
+class StreamedFormat
+{
+  public:
+    using record_t = typename Format::record_t;
+
+    explicit StreamedFormat(const StreamedInput &input) : input(input), format(input.data(), input.wait(Format::extent(0) + maxparameterssize)) {}
+
+    size_t begin() const { return format.begin(); }
+    parameters_t parameters() const { return format.parameters(); }
+    size_t end() const { return current(0).end(); }
+    char kind(size_t offset) const { return current(Format::extent(offset)).kind(offset); }
+    size_t next(size_t offset) const { return current(Format::extent(offset)).next(offset); }
+    void record(size_t offset, record_t &record) const { current(Format::extent(offset)).record(offset, record); }
+
+  private:
+    Format current(size_t end) const { return Format(format, input.wait(end)); }
+
+    const StreamedInput &input;
+    const Format format;
+};
+
+#endif
@@ -0,0 +1,488 @@
+#ifndef TRAVERSAL_H
+#define TRAVERSAL_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <stack>
+#include <sys/types.h>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../common/check.h"
+#include "results.h"
+#include "stats.h"
+
+static const int fixedpointexponent = 29;
+static const int32_t fixedpointone = (1 << fixedpointexponent);
+static const std::array<std::array<uint8_t, 3>, 6> permutations = {{{0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}}};
+
+struct qxybounds_t {
+    // lower.at(0) <= Q_X(1) * 2^fixedpointexponent <= upper.at(0)
+    // lower.at(1) <= Q_X(2) * 2^fixedpointexponent <= upper.at(1)
+    // lower.at(2) <= Q_X(3) * 2^fixedpointexponent <= upper.at(2)
+    // lower.at(3) <= Q_Y(1) * 2^fixedpointexponent <= upper.at(3)
+    // lower.at(4) <= Q_Y(2) * 2^fixedpointexponent <= upper.at(4)
+    // lower.at(5) <= Q_Y(3) * 2^fixedpointexponent <= upper.at(5)
+
+    std::array<int32_t, 6> lower;
+    std::array<int32_t, 6> upper;
+};
+
+static const qxybounds_t rootqxybounds = {{0, 0, 0, 0, 0, 0}, {fixedpointone, fixedpointone, fixedpointone, fixedpointone, fixedpointone, fixedpointone}};
+
+static inline bool valid(const qxybounds_t &qxybounds)
+{
+    for (uint j = 0; j < 6; ++j) {
+        if ((qxybounds.lower.at(j) < 0) || (qxybounds.lower.at(j) >= qxybounds.upper.at(j)) || (qxybounds.upper.at(j) > fixedpointone)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// tighten without checks, for callers that test the result with valid (e.g., when choosing among splits)
+
+static inline void tightenunchecked(qxybounds_t &qxybounds)
+{
+    qxybounds.lower.at(0) = std::max(qxybounds.lower.at(0), fixedpointone - qxybounds.upper.at(1) - qxybounds.upper.at(2));
+    qxybounds.lower.at(1) = std::max(qxybounds.lower.at(1), fixedpointone - qxybounds.upper.at(0) - qxybounds.upper.at(2));
+    qxybounds.lower.at(2) = std::max(qxybounds.lower.at(2), fixedpointone - qxybounds.upper.at(0) - qxybounds.upper.at(1));
+    qxybounds.lower.at(3) = std::max(qxybounds.lower.at(3), fixedpointone - qxybounds.upper.at(4) - qxybounds.upper.at(5));
+    qxybounds.lower.at(4) = std::max(qxybounds.lower.at(4), fixedpointone - qxybounds.upper.at(3) - qxybounds.upper.at(5));
+    qxybounds.lower.at(5) = std::max(qxybounds.lower.at(5), fixedpointone - qxybounds.upper.at(3) - qxybounds.upper.at(4));
+    qxybounds.upper.at(0) = std::min(qxybounds.upper.at(0), fixedpointone - qxybounds.lower.at(1) - qxybounds.lower.at(2));
+    qxybounds.upper.at(1) = std::min(qxybounds.upper.at(1), fixedpointone - qxybounds.lower.at(0) - qxybounds.lower.at(2));
+    qxybounds.upper.at(2) = std::min(qxybounds.upper.at(2), fixedpointone - qxybounds.lower.at(0) - qxybounds.lower.at(1));
+    qxybounds.upper.at(3) = std::min(qxybounds.upper.at(3), fixedpointone - qxybounds.lower.at(4) - qxybounds.lower.at(5));
+    qxybounds.upper.at(4) = std::min(qxybounds.upper.at(4), fixedpointone - qxybounds.lower.at(3) - qxybounds.lower.at(5));
+    qxybounds.upper.at(5) = std::min(qxybounds.upper.at(5), fixedpointone - qxybounds.lower.at(3) - qxybounds.lower.at(4));
+}
+
+static inline void tighten(qxybounds_t &qxybounds)
+{
+    CHECK(valid(qxybounds));
+    tightenunchecked(qxybounds);
+    CHECK(valid(qxybounds));
+}
+
+static inline void split(const qxybounds_t &qxybounds, char splitline, qxybounds_t &lower, qxybounds_t &upper)
+{
+    CHECK((splitline >= 'a') && (splitline <= 'f'));
+    const uint splitindex = uint(splitline - 'a');
+
+    // prepare split
+
+    CHECK((qxybounds.lower.at(splitindex) % 2) == 0);
+    CHECK((qxybounds.upper.at(splitindex) % 2) == 0);
+    const int32_t middlevalue = ((qxybounds.lower.at(splitindex) / 2) + (qxybounds.upper.at(splitindex) / 2));
+
+    // construct lower and upper part
+
+    lower = qxybounds;
+    upper = qxybounds;
+    lower.upper.at(splitindex) = middlevalue;
+    upper.lower.at(splitindex) = middlevalue;
+}
+
+// the extreme points of Q_X (base 0) or Q_Y (base 3) in tightened bounds: one coordinate at its lower bound, a
+// different one at its upper bound, and the third one determined by the sum
+
+struct extremepoints_t {
+    // the distinct points in ascending order, stored in place (there are at most six, one per permutation)
+
+    std::array<std::array<int32_t, 3>, 6> points;
+    size_t count = 0;
+
+    const std::array<int32_t, 3> *begin() const { return points.data(); }
+    const std::array<int32_t, 3> *end() const { return points.data() + count; }
+    size_t size() const { return count; }
+    void clear() { count = 0; }
+    void insert(const std::array<int32_t, 3> &point);
+};
+
+inline void extremepoints_t::insert(const std::array<int32_t, 3> &point)
+{
+    size_t index = 0;
+
+    while ((index < count) && (points.at(index) < point)) {
+        ++index;
+    }
+
+    if ((index < count) && (points.at(index) == point)) {
+        return;
+    }
+
+    CHECK(count < points.size());
+
+    for (size_t i = count; i > index; --i) {
+        points.at(i) = points.at(i - 1);
+    }
+
+    points.at(index) = point;
+    ++count;
+}
+
+static inline void findextremepoints(const qxybounds_t &qxybounds, uint base, extremepoints_t &points)
+{
+    points.clear();
+
+    for (const std::array<uint8_t, 3> &permutation : permutations) {
+        const int32_t qlower = qxybounds.lower.at(base + permutation.at(0));
+        const int32_t qupper = qxybounds.upper.at(base + permutation.at(1));
+        const int32_t qother = (fixedpointone - qlower - qupper);
+
+        CHECK(qother >= qxybounds.lower.at(base + permutation.at(2)));
+        CHECK(qother <= qxybounds.upper.at(base + permutation.at(2)));
+
+        std::array<int32_t, 3> q = {};
+        q.at(permutation.at(0)) = qlower;
+        q.at(permutation.at(1)) = qupper;
+        q.at(permutation.at(2)) = qother;
+        points.insert(q);
+    }
+}
+
+// serial traversal: pop, tighten, then visit a leaf or split, reading the certificate as the stack is walked; the
+// state after every leaf is enough to continue the walk later (see checkpoint.h)
+
+struct walkstate_t {
+    std::vector<qxybounds_t> stack;
+    size_t offset;  // offset of the next node in the certificate
+    uint64_t leafs; // number of leaves visited so far
+};
+
+template <typename Format, typename Visitor>
+void walk(const Format &format, walkstate_t &state, Visitor &&visit)
+{
+    std::vector<qxybounds_t> &stack = state.stack;
+    typename Format::record_t record = {};
+    statsstart();
+
+    while (!stack.empty()) {
+        // get top case from stack
+
+        qxybounds_t qxybounds = stack.back();
+        stack.pop_back();
+        tighten(qxybounds);
+        statslap(tightening);
+
+        // process next node
+
+        const char kind = format.kind(state.offset);
+
+        if (kind == 'v') {
+            format.record(state.offset, record);
+            state.offset = format.next(state.offset);
+            ++state.leafs;
+            statslap(parsing);
+            statsleaf(true, double(state.offset - format.begin()) / double(format.end() - format.begin()));
+            visit(qxybounds, record);
+            continue;
+        }
+
+        // push parts to stack
+
+        qxybounds_t lower;
+        qxybounds_t upper;
+        split(qxybounds, kind, lower, upper);
+        state.offset = format.next(state.offset);
+        stack.push_back(upper);
+        stack.push_back(lower);
+        statssplit(stack.size());
+        statslap(parsing);
+    }
+
+    statsmerge();
+}
+
+template <typename Format, typename Visitor>
+void walk(const Format &format, Visitor &&visit)
+{
+    walkstate_t state = {{rootqxybounds}, format.begin(), 0};
+    walk(format, state, visit);
+}
+
+// ring of leaves from a single producer to a single consumer without locks: each side only writes its own counter,
+// and waits (by yielding) while the ring is full or empty
+
+static const size_t ringsize = 1024;
+
+template <typename Record>
+class LeafRing
+{
+  public:
+    void push(const qxybounds_t &qxybounds, const Record &record);
+    bool pop(qxybounds_t &qxybounds, Record &record);
+    void close() { closed.store(true, std::memory_order_release); }
+
+  private:
+    struct slot_t {
+        qxybounds_t qxybounds;
+        Record record;
+    };
+
+    std::array<slot_t, ringsize> slots;
+    alignas(64) std::atomic<size_t> pushed{0};
+    alignas(64) std::atomic<size_t> popped{0};
+    std::atomic<bool> closed{false};
+};
+
+template <typename Record>
+void LeafRing<Record>::push(const qxybounds_t &qxybounds, const Record &record)
+{
+    const size_t index = pushed.load(std::memory_order_relaxed);
+
+    while (index - popped.load(std::memory_order_acquire) == ringsize) {
+        std::this_thread::yield();
+    }
+
+    slots.at(index % ringsize) = slot_t{qxybounds, record};
+    pushed.store(index + 1, std::memory_order_release);
+}
+
+template <typename Record>
+bool LeafRing<Record>::pop(qxybounds_t &qxybounds, Record &record)
+{
+    // false once the ring is closed and empty
+
+    const size_t index = popped.load(std::memory_order_relaxed);
+
+    while (pushed.load(std::memory_order_acquire) == index) {
+        if (closed.load(std::memory_order_acquire) && (pushed.load(std::memory_order_acquire) == index)) {
+            return false;
+        }
+
+        std::this_thread::yield();
+    }
+
+    qxybounds = slots.at(index % ringsize).qxybounds;
+    record = slots.at(index % ringsize).record;
+    popped.store(index + 1, std::memory_order_release);
+    return true;
+}
+
+// the certificate is read, parsed and tightened by walk on a second thread, which hands the leaves to the verifier
+// through a LeafRing, so that reading overlaps with the verification; as in traverseparallel, the verifier is finished
+// after the last leaf (the results are added as verify returns, so a verifier that defers leaves, i.e., BatchVerifier,
+// is only used with traverseparallel)
+
+template <typename Verifier, typename Format>
+void traverse(Verifier &verifier, const Format &format)
+{
+    LeafRing<typename Format::record_t> ring;
+    std::thread reader([&]() {
+        // the time spent waiting for the verifier is not attributed to a phase
+
+        walk(format, [&](const qxybounds_t &qxybounds, const typename Format::record_t &record) {
+            ring.push(qxybounds, record);
+            statsstart();
+        });
+        ring.close();
+    });
+
+    result_t result = {};
+    qxybounds_t qxybounds;
+    typename Format::record_t record = {};
+
+    while (ring.pop(qxybounds, record)) {
+        statsstart();
+        CHECK(verifier.verify(qxybounds, record, result));
+        resultsadd(result);
+        statslap(finalcheck);
+    }
+
+    verifier.finish();
+    reader.join();
+    statsmerge();
+}
+
+// parallel traversal: the certificate is a preorder listing of the split tree (lower part before upper part), so a
+// pre-scan can record where every subtree ends; independent subtrees are then handed to a work-stealing pool
+
+struct node_t {
+    size_t offset; // offset of the node in the certificate
+    size_t end;    // index of the first node after the subtree rooted here
+    size_t leaf;   // ordinal of the first leaf in the subtree rooted here
+};
+
+struct task_t {
+    qxybounds_t qxybounds;
+    size_t node;
+};
+
+template <typename Format>
+class Tree
+{
+  public:
+    explicit Tree(const Format &format);
+
+    size_t nodecount() const { return nodes.size(); }
+    size_t leafcount() const { return leafs; }
+    const node_t &node(size_t index) const { return nodes.at(index); }
+
+  private:
+    std::vector<node_t> nodes;
+    size_t leafs = 0;
+};
+
+template <typename Format>
+Tree<Format>::Tree(const Format &format)
+{
+    // the stack holds the split nodes whose subtrees are still incomplete and how many children they still miss
+
+    std::stack<std::pair<size_t, uint>> open;
+    size_t offset = format.begin();
+
+    do {
+        const char kind = format.kind(offset);
+        nodes.push_back(node_t{offset, 0, leafs});
+        offset = format.next(offset);
+
+        if (kind != 'v') {
+            CHECK((kind >= 'a') && (kind <= 'f'));
+            open.emplace(nodes.size() - 1, 2);
+            continue;
+        }
+
+        nodes.back().end = nodes.size();
+        ++leafs;
+
+        // a completed subtree completes every parent that was only waiting for it
+
+        while (!open.empty() && (--open.top().second == 0)) {
+            nodes.at(open.top().first).end = nodes.size();
+            open.pop();
+        }
+    } while (!open.empty());
+}
+
+class Workers
+{
+  public:
+    explicit Workers(uint threads) : queues(threads), locks(threads) {}
+
+    void push(uint worker, const task_t &task);
+    bool pop(uint worker, task_t &task);
+    void done() { --pending; }
+    bool finished() const { return pending.load() == 0; }
+
+  private:
+    std::vector<std::deque<task_t>> queues;
+    std::vector<std::mutex> locks;
+    std::atomic<size_t> pending{0};
+};
+
+inline void Workers::push(uint worker, const task_t &task)
+{
+    ++pending;
+    std::lock_guard<std::mutex> guard(locks.at(worker));
+    queues.at(worker).push_back(task);
+}
+
+inline bool Workers::pop(uint worker, task_t &task)
+{
+    // take the most recent own task (depth-first), otherwise steal the oldest (largest) task of another worker
+
+    for (uint k = 0; k < queues.size(); ++k) {
+        const uint victim = (worker + k) % queues.size();
+        std::lock_guard<std::mutex> guard(locks.at(victim));
+        std::deque<task_t> &queue = queues.at(victim);
+
+        if (queue.empty()) {
+            continue;
+        }
+
+        if (k == 0) {
+            task = queue.back();
+            queue.pop_back();
+        } else {
+            task = queue.front();
+            queue.pop_front();
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+template <typename Verifier, typename Format, typename... Args>
+void traverseparallel(uint threads, const Format &format, const Args &... args)
+{
+    statsstart();
+    const Tree<Format> tree(format);
+    statslap(parsing);
+    std::vector<result_t> results(tree.leafcount());
+    Workers workers(threads);
+    workers.push(0, task_t{rootqxybounds, 0});
+
+    auto work = [&](uint worker) {
+        Verifier verifier(args...);
+        typename Format::record_t record = {};
+        task_t task;
+        statsstart();
+
+        while (!workers.finished()) {
+            if (!workers.pop(worker, task)) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            // walk down the lower parts and leave the upper parts to be stolen
+
+            while (true) {
+                tighten(task.qxybounds);
+                statslap(tightening);
+                const node_t &node = tree.node(task.node);
+                const char kind = format.kind(node.offset);
+
+                if (kind == 'v') {
+                    format.record(node.offset, record);
+                    statslap(parsing);
+                    statsleaf(worker == 0, double(progressleafs.load()) / double(tree.leafcount()));
+                    CHECK(verifier.verify(task.qxybounds, record, results.at(node.leaf)));
+                    statslap(finalcheck);
+                    break;
+                }
+
+                qxybounds_t lower;
+                qxybounds_t upper;
+                split(task.qxybounds, kind, lower, upper);
+                workers.push(worker, task_t{upper, tree.node(task.node + 1).end});
+                task = task_t{lower, task.node + 1};
+                statssplit(0);
+                statslap(parsing);
+            }
+
+            workers.done();
+        }
+
+        verifier.finish();
+        statsmerge();
+    };
+
+    std::vector<std::thread> pool;
+
+    for (uint worker = 1; worker < threads; ++worker) {
+        pool.emplace_back(work, worker);
+    }
+
+    work(0);
+
+    for (std::thread &thread : pool) {
+        thread.join();
+    }
+
+    for (const result_t &result : results) {
+        resultsadd(result);
+    }
+}
+
+#endif
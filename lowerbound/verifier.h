@@ -0,0 +1,1088 @@
+#ifndef VERIFIER_H
+#define VERIFIER_H
+
+#include <array>
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../common/arena.h"
+#include "../common/arguments.h"
+#include "../common/backend.h"
+#include "../common/dbl.h"
+#include "../common/dd.h"
+#include "../common/mpfrbackend.h"
+#include "cache.h"
+#include "certificate.h"
+#include "checkpoint.h"
+#include "stats.h"
+#include "stream.h"
+#include "traversal.h"
+
+static cachecounters_t logcounters;
+static cachecounters_t powercounters;
+static cachecounters_t ptermcounters;
+static std::atomic<uint64_t> adaptiveleafs{0};
+static std::atomic<uint64_t> adaptiveescalations{0};
+static std::atomic<uint64_t> batchleafs{0};
+static std::atomic<uint64_t> batchescalations{0};
+
+// the P-term only depends on alpha and the betas, which certificates often repeat, so it is cached with the raw
+// numbers of the leaf as the key
+
+static inline uint cacheslot(const leaf_t &key)
+{
+    uint64_t hash = key.alpha;
+
+    for (const uint64_t beta : key.beta) {
+        hash = (hash * UINT64_C(0x9e3779b97f4a7c15)) ^ beta;
+    }
+
+    return cacheslot(int32_t(uint32_t(hash) ^ uint32_t(hash >> 32)));
+}
+
+// P_XY(x, y) = pxynumerator(x, y) / pxydenominator
+
+static const long pxydenominator = 60000;
+
+static inline long pxynumerator(uint x, uint y)
+{
+    return (x == y) ? 6 : 9997;
+}
+
+// verification of a single leaf with Lemma 16, for any number backend (see backend.h): the values are computed as
+// lower bounds for D and as upper bounds for the P-term, so that the result is a lower bound; verify returns whether
+// this lower bound exceeds lowerbound, i.e., false if the precision of the backend was not sufficient; the values for
+// the further rates of --rates (see results.h) are only recorded for a leaf that is verified
+
+template <typename Backend>
+class Verifier
+{
+  public:
+    using number_t = typename Backend::number_t;
+
+    Verifier(const char *ratestr, const char *lowerboundstr, bool failedratesinconclusive = false);
+    ~Verifier();
+
+    bool verify(const qxybounds_t &qxybounds, const leaf_t &leaf, result_t &result);
+    void finish() {}
+
+  private:
+    struct rate_t {
+        number_t rate;
+        number_t lowerbound;
+        uint64_t failures = 0;
+        result_t minimum = {};
+        result_t value = {}; // of the current leaf
+        bool failed = false;
+    };
+
+    uint prune(const leaf_t &leaf, const extremepoints_t &qxextremepoints, const extremepoints_t &qyextremepoints);
+    number_t &power(int32_t coordinate, uint64_t alphakey);
+    void log(number_t &result, const number_t &a, rounding_t rounding);
+    void exp(number_t &result, const number_t &a, rounding_t rounding);
+
+    number_t alpha;
+    number_t logdifference;
+    number_t lowerbound;
+    number_t oneminusalpha;
+    number_t qxybetamin;
+    number_t rate;
+    number_t tmpa;
+    number_t tmpb;
+    uint powercount = 0;
+    uint64_t rateleafs = 0;
+    std::vector<rate_t> rates; // the further rates of --rates
+    bool failedratesinconclusive; // whether a leaf at which a further pair fails is inconclusive, see AdaptiveVerifier
+    std::array<number_t, 9> beta;
+    std::array<number_t, 9> logpxy;
+    std::array<number_t, 36> powers;
+    std::array<int32_t, 36> powercoordinates;
+    std::array<std::array<number_t, 3>, 6> qyweights;
+    std::array<std::array<bool, 6>, 6> candidates; // the pairs of extreme points that may attain the minimum D
+    Cache<int32_t, number_t> logcache{logcounters};
+    Cache<std::pair<int32_t, uint64_t>, number_t> powercache{powercounters};
+    Cache<leaf_t, number_t> ptermcache{ptermcounters};
+};
+
+template <typename Backend>
+Verifier<Backend>::Verifier(const char *ratestr, const char *lowerboundstr, bool failedratesinconclusive) : rates(resultsrates.size()), failedratesinconclusive(failedratesinconclusive)
+{
+    arenainstall();
+    mpfr_fillcaches();
+
+    Backend::setstr(rate, ratestr);
+    CHECK(Backend::cmpsi(rate, 0) > 0);
+    CHECK(Backend::cmpsi(rate, 1) < 0);
+
+    Backend::setstr(lowerbound, lowerboundstr);
+    CHECK(Backend::cmpsi(lowerbound, 0) > 0);
+    CHECK(Backend::cmpsi(lowerbound, 1) < 0);
+
+    for (uint i = 0; i < rates.size(); ++i) {
+        Backend::setstr(rates.at(i).rate, resultsrates.at(i).rate.c_str());
+        CHECK(Backend::cmpsi(rates.at(i).rate, 0) > 0);
+        CHECK(Backend::cmpsi(rates.at(i).rate, 1) < 0);
+
+        Backend::setstr(rates.at(i).lowerbound, resultsrates.at(i).lowerbound.c_str());
+        CHECK(Backend::cmpsi(rates.at(i).lowerbound, 0) > 0);
+        CHECK(Backend::cmpsi(rates.at(i).lowerbound, 1) < 0);
+    }
+
+    for (uint x = 0; x < 3; ++x) {
+        for (uint y = 0; y < 3; ++y) {
+            Backend::setsi(tmpa, pxynumerator(x, y));
+            Backend::divsi(tmpa, tmpa, pxydenominator, up);
+            Backend::log(logpxy.at(3 * x + y), tmpa, up);
+        }
+    }
+}
+
+template <typename Backend>
+Verifier<Backend>::~Verifier()
+{
+    for (uint i = 0; i < rates.size(); ++i) {
+        resultsmergerate(resultsrates.at(i), rateleafs, rates.at(i).failures, rates.at(i).minimum);
+    }
+}
+
+template <typename Backend>
+void Verifier<Backend>::log(number_t &result, const number_t &a, rounding_t rounding)
+{
+    Backend::log(result, a, rounding);
+
+    if (statsenabled) {
+        ++threadstats.logs;
+    }
+}
+
+template <typename Backend>
+void Verifier<Backend>::exp(number_t &result, const number_t &a, rounding_t rounding)
+{
+    Backend::exp(result, a, rounding);
+
+    if (statsenabled) {
+        ++threadstats.exps;
+    }
+}
+
+template <typename Backend>
+uint Verifier<Backend>::prune(const leaf_t &leaf, const extremepoints_t &qxextremepoints, const extremepoints_t &qyextremepoints)
+{
+    // bound the sum of every pair of extreme points from below and above in double precision (see dbl.h); a pair
+    // whose lower bound exceeds the upper bound of another pair cannot attain the minimum, so only the candidates
+    // are evaluated with Backend (and only their coordinates need a power)
+
+    const double alpha = std::ldexp(double(leaf.alpha), -leafexponent);
+    const double oneminusalphalower = dbl_down(1 - dbl_up(alpha));
+    const double oneminusalphaupper = dbl_up(1 - dbl_down(alpha));
+    std::array<double, 9> betalower;
+    std::array<double, 9> betaupper;
+
+    for (uint i = 0; i < 9; ++i) {
+        betalower.at(i) = dbl_down(std::ldexp(double(leaf.beta.at(i)), -leafexponent));
+        betaupper.at(i) = dbl_up(std::ldexp(double(leaf.beta.at(i)), -leafexponent));
+    }
+
+    auto powerbounds = [&](int32_t coordinate, double &lower, double &upper) {
+        lower = 0;
+        upper = 0;
+
+        if (coordinate > 0) {
+            const double q = std::ldexp(double(coordinate), -fixedpointexponent);
+            lower = dbl_explower(dbl_mullower(dbl_loglower(q), oneminusalphalower, oneminusalphaupper));
+            upper = dbl_expupper(dbl_mulupper(dbl_logupper(q), oneminusalphalower, oneminusalphaupper));
+        }
+    };
+
+    std::array<std::array<double, 3>, 6> weightlower;
+    std::array<std::array<double, 3>, 6> weightupper;
+    uint qycount = 0;
+
+    for (const std::array<int32_t, 3> &qy : qyextremepoints) {
+        std::array<double, 3> powerlower;
+        std::array<double, 3> powerupper;
+
+        for (uint y = 0; y < 3; ++y) {
+            powerbounds(qy.at(y), powerlower.at(y), powerupper.at(y));
+        }
+
+        for (uint x = 0; x < 3; ++x) {
+            weightlower.at(qycount).at(x) = 0;
+            weightupper.at(qycount).at(x) = 0;
+
+            for (uint y = 0; y < 3; ++y) {
+                weightlower.at(qycount).at(x) = dbl_down(weightlower.at(qycount).at(x) + dbl_down(powerlower.at(y) * betalower.at(3 * x + y)));
+                weightupper.at(qycount).at(x) = dbl_up(weightupper.at(qycount).at(x) + dbl_up(powerupper.at(y) * betaupper.at(3 * x + y)));
+            }
+        }
+
+        ++qycount;
+    }
+
+    std::array<std::array<double, 6>, 6> sumlower;
+    double minupper = HUGE_VAL;
+    uint qxcount = 0;
+
+    for (const std::array<int32_t, 3> &qx : qxextremepoints) {
+        std::array<double, 3> powerlower;
+        std::array<double, 3> powerupper;
+
+        for (uint x = 0; x < 3; ++x) {
+            powerbounds(qx.at(x), powerlower.at(x), powerupper.at(x));
+        }
+
+        for (uint j = 0; j < qycount; ++j) {
+            double lower = 0;
+            double upper = 0;
+
+            for (uint x = 0; x < 3; ++x) {
+                lower = dbl_down(lower + dbl_down(powerlower.at(x) * weightlower.at(j).at(x)));
+                upper = dbl_up(upper + dbl_up(powerupper.at(x) * weightupper.at(j).at(x)));
+            }
+
+            sumlower.at(qxcount).at(j) = lower;
+            minupper = std::min(minupper, upper);
+        }
+
+        ++qxcount;
+    }
+
+    uint pruned = 0;
+
+    for (uint i = 0; i < qxcount; ++i) {
+        for (uint j = 0; j < qycount; ++j) {
+            candidates.at(i).at(j) = !(sumlower.at(i).at(j) > minupper);
+            pruned += candidates.at(i).at(j) ? 0 : 1;
+        }
+    }
+
+    return pruned;
+}
+
+template <typename Backend>
+typename Backend::number_t &Verifier<Backend>::power(int32_t coordinate, uint64_t alphakey)
+{
+    // lower bound of (coordinate / 2^fixedpointexponent)^{1-\alpha}, evaluated at most once per leaf and
+    // reusing the work of earlier leaves where possible
+
+    for (uint i = 0; i < powercount; ++i) {
+        if (powercoordinates.at(i) == coordinate) {
+            return powers.at(i);
+        }
+    }
+
+    CHECK(coordinate > 0);
+    CHECK(powercount < powers.size());
+    powercoordinates.at(powercount) = coordinate;
+    number_t &value = powers.at(powercount++);
+
+    // look for the power of an earlier leaf with the same alpha, then for the logarithm of the coordinate
+
+    const std::pair<int32_t, uint64_t> powerkey(coordinate, alphakey);
+    number_t *cached = powercache.find(powerkey);
+
+    if (cached != nullptr) {
+        Backend::set(value, *cached);
+        return value;
+    }
+
+    cached = logcache.find(coordinate);
+
+    if (cached == nullptr) {
+        cached = &logcache.insert(coordinate);
+        Backend::setsi(*cached, coordinate);
+        Backend::div2si(*cached, *cached, fixedpointexponent);
+        log(*cached, *cached, down);
+    }
+
+    Backend::mul(value, *cached, oneminusalpha, down);
+    CHECK(Backend::bounded(value));
+    exp(value, value, down);
+    Backend::set(powercache.insert(powerkey), value);
+    return value;
+}
+
+template <typename Backend>
+bool Verifier<Backend>::verify(const qxybounds_t &qxybounds, const leaf_t &leaf, result_t &result)
+{
+    // the temporaries of MPFR and MPFI come from the arena
+
+    const ArenaScope scope;
+
+    // initialize values and perform basic checks
+
+    Backend::setui2exp(alpha, leaf.alpha, -leafexponent);
+    CHECK(Backend::cmpd(alpha, 0.001) > 0);
+    CHECK(Backend::cmpd(alpha, 0.999) < 0);
+
+    for (uint i = 0; i < 9; ++i) {
+        Backend::setui2exp(beta.at(i), leaf.beta.at(i), -leafexponent);
+        CHECK(Backend::cmpsi(beta.at(i), 0) >= 0);
+        CHECK(Backend::cmpsi(beta.at(i), 9) < 0);
+    }
+
+    Backend::sisub(oneminusalpha, 1, alpha, exact);
+
+    // determine extreme points
+
+    extremepoints_t qxextremepoints;
+    extremepoints_t qyextremepoints;
+    findextremepoints(qxybounds, 0, qxextremepoints);
+    findextremepoints(qxybounds, 3, qyextremepoints);
+
+    // compute D = qxybetamin = \min_j \sum_{x,y} Q_j(x,y)^{1-\alpha} \beta(x,y)
+    // with (Q_X(x) Q_Y(y))^{1-\alpha} = Q_X(x)^{1-\alpha} Q_Y(y)^{1-\alpha}, so that only the coordinates of the
+    // extreme points need a power and every Q_Y enters through qyweights(x) = \sum_y Q_Y(y)^{1-\alpha} \beta(x,y);
+    // the minimum is only taken over the candidates of prune
+
+    const uint pruned = prune(leaf, qxextremepoints, qyextremepoints);
+    powercount = 0;
+    uint qycount = 0;
+
+    for (const std::array<int32_t, 3> &qy : qyextremepoints) {
+        bool candidate = false;
+
+        for (uint i = 0; i < qxextremepoints.size(); ++i) {
+            candidate = candidate || candidates.at(i).at(qycount);
+        }
+
+        for (uint x = 0; (x < 3) && candidate; ++x) {
+            Backend::setzero(qyweights.at(qycount).at(x));
+
+            for (uint y = 0; y < 3; ++y) {
+                if (qy.at(y) == 0) {
+                    continue;
+                }
+
+                Backend::mul(tmpb, power(qy.at(y), leaf.alpha), beta.at(3 * x + y), down);
+                Backend::add(qyweights.at(qycount).at(x), qyweights.at(qycount).at(x), tmpb, down);
+            }
+        }
+
+        ++qycount;
+    }
+
+    Backend::setinf(qxybetamin);
+    uint qxcount = 0;
+
+    for (const std::array<int32_t, 3> &qx : qxextremepoints) {
+        for (uint j = 0; j < qycount; ++j) {
+            if (!candidates.at(qxcount).at(j)) {
+                continue;
+            }
+
+            Backend::setzero(tmpa);
+
+            for (uint x = 0; x < 3; ++x) {
+                if (qx.at(x) == 0) {
+                    continue;
+                }
+
+                Backend::mul(tmpb, power(qx.at(x), leaf.alpha), qyweights.at(j).at(x), down);
+                Backend::add(tmpa, tmpa, tmpb, down);
+            }
+
+            CHECK(Backend::bounded(tmpa));
+            Backend::min(qxybetamin, tmpa);
+        }
+
+        ++qxcount;
+    }
+
+    CHECK(Backend::regular(qxybetamin));
+
+    if (statsenabled) {
+        threadstats.extremepoints += qxextremepoints.size() * qycount - pruned;
+        threadstats.prunedpairs += pruned;
+    }
+
+    statslap(extremepoints);
+
+    // compute \left[ \sum_{x,y} (P(x,y)^\alpha + \beta(x,y))^\frac{1}{\alpha} \right]^\alpha, unless an earlier leaf had
+    // the same alpha and betas
+
+    number_t *cached = ptermcache.find(leaf);
+
+    if (cached != nullptr) {
+        Backend::set(tmpa, *cached);
+    } else {
+        Backend::setzero(tmpa);
+
+        for (uint i = 0; i < 9; ++i) {
+            Backend::mul(tmpb, logpxy.at(i), alpha, up);
+            exp(tmpb, tmpb, up);
+            Backend::add(tmpb, tmpb, beta.at(i), up);
+            log(tmpb, tmpb, up);
+            Backend::div(tmpb, tmpb, alpha, up);
+            exp(tmpb, tmpb, up);
+            Backend::add(tmpa, tmpa, tmpb, up);
+        }
+
+        log(tmpa, tmpa, up);
+        Backend::mul(tmpa, tmpa, alpha, up);
+        exp(tmpa, tmpa, up);
+        Backend::set(ptermcache.insert(leaf), tmpa);
+    }
+
+    // compute value = -\frac{\log \{[...]^\alpha - D\} + (1 - \alpha) \cdot rate}{\alpha}, where only the last
+    // term depends on the rate
+
+    Backend::sub(tmpa, tmpa, qxybetamin, up);
+    log(logdifference, tmpa, up);
+    Backend::mul(tmpb, oneminusalpha, rate, up);
+    Backend::add(tmpa, logdifference, tmpb, up);
+    Backend::div(tmpa, tmpa, alpha, up);
+    Backend::neg(tmpa, tmpa);
+    statslap(pterm);
+
+    // check that value > lowerbound
+
+    if (Backend::cmp(lowerbound, tmpa) >= 0) {
+        return false;
+    }
+
+    Backend::get2exp(result.mantissa, result.exponent, tmpa, down);
+    result.text.at(0) = '\0';
+
+    if (!resultsquiet) {
+        CHECK(Backend::snprintf(result.text.data(), result.text.size(), "%.20RDf", tmpa, down) < int(result.text.size()));
+    }
+
+    // the same value for the further rates, which only have to be recorded; if a pair fails and
+    // failedratesinconclusive is set, nothing is recorded and the leaf is inconclusive
+
+    bool failed = false;
+
+    for (rate_t &further : rates) {
+        Backend::mul(tmpb, oneminusalpha, further.rate, up);
+        Backend::add(tmpb, logdifference, tmpb, up);
+        Backend::div(tmpb, tmpb, alpha, up);
+        Backend::neg(tmpb, tmpb);
+        further.failed = (Backend::cmp(further.lowerbound, tmpb) >= 0);
+        failed = failed || further.failed;
+        Backend::get2exp(further.value.mantissa, further.value.exponent, tmpb, down);
+    }
+
+    if (failed && failedratesinconclusive) {
+        statslap(finalcheck);
+        return false;
+    }
+
+    for (rate_t &further : rates) {
+        further.failures += further.failed ? 1 : 0;
+
+        if ((rateleafs == 0) || resultless(further.value, further.minimum)) {
+            further.minimum.mantissa = further.value.mantissa;
+            further.minimum.exponent = further.value.exponent;
+        }
+    }
+
+    ++rateleafs;
+    statslap(finalcheck);
+    return true;
+}
+
+// adaptive precision: every leaf is verified with a fast (low-precision) backend first, and only a leaf for which the
+// result is inconclusive is verified again with the precise backend; with --rates, this includes a leaf at which a
+// further pair fails with the fast backend, so that the failures are those of the precise backend
+
+template <typename FastBackend, typename Backend>
+class AdaptiveVerifier
+{
+  public:
+    AdaptiveVerifier(const char *ratestr, const char *lowerboundstr) : fast(ratestr, lowerboundstr, true), precise(ratestr, lowerboundstr) {}
+    ~AdaptiveVerifier();
+
+    bool verify(const qxybounds_t &qxybounds, const leaf_t &leaf, result_t &result);
+    void finish() {}
+
+  private:
+    Verifier<FastBackend> fast;
+    Verifier<Backend> precise;
+    uint64_t leafs = 0;
+    uint64_t escalations = 0;
+};
+
+template <typename FastBackend, typename Backend>
+AdaptiveVerifier<FastBackend, Backend>::~AdaptiveVerifier()
+{
+    adaptiveleafs += leafs;
+    adaptiveescalations += escalations;
+}
+
+template <typename FastBackend, typename Backend>
+bool AdaptiveVerifier<FastBackend, Backend>::verify(const qxybounds_t &qxybounds, const leaf_t &leaf, result_t &result)
+{
+    ++leafs;
+
+    if (fast.verify(qxybounds, leaf, result)) {
+        return true;
+    }
+
+    ++escalations;
+    return precise.verify(qxybounds, leaf, result);
+}
+
+// batched verification: batchlanes leaves are gathered into a structure of arrays (one array over the lanes per
+// coordinate of an extreme point, alpha and beta) and evaluated in lockstep with the double bounds of dbl.h, where
+// every inner loop runs over the lanes so that the compiler can vectorize it; a lane whose result is inconclusive is
+// verified again with Backend
+//
+// verify only records the leaf (and returns true) until the buffer is full, so the result is only written once the
+// batch has been evaluated, and finish evaluates the remaining leaves
+
+static const uint batchlanes = 8;
+
+template <typename Backend>
+class BatchVerifier
+{
+  public:
+    BatchVerifier(const char *ratestr, const char *lowerboundstr);
+    ~BatchVerifier();
+
+    bool verify(const qxybounds_t &qxybounds, const leaf_t &leaf, result_t &result);
+    void finish();
+
+  private:
+    using lanes_t = std::array<double, batchlanes>;
+
+    Verifier<Backend> scalar;
+    double lowerbound; // upper bound of the lower bound, and upper bounds of the rate and of log(P_XY)
+    double rate;
+    std::array<double, 9> logpxy;
+    uint count = 0;
+    std::array<qxybounds_t, batchlanes> qxybounds;
+    std::array<leaf_t, batchlanes> leafs;
+    std::array<result_t *, batchlanes> results;
+    std::array<std::array<lanes_t, 3>, 6> qxpowers; // the coordinates of the extreme points, then their powers
+    std::array<std::array<lanes_t, 3>, 6> qypowers;
+    std::array<std::array<lanes_t, 3>, 6> qyweights;
+    std::array<lanes_t, 9> betalower;
+    std::array<lanes_t, 9> betaupper;
+    lanes_t alphalower = {};
+    lanes_t alphaupper = {};
+    lanes_t qxybetamin;
+    lanes_t pterm;
+    lanes_t value;
+    uint64_t leafcount = 0;
+    uint64_t escalations = 0;
+};
+
+template <typename Backend>
+BatchVerifier<Backend>::BatchVerifier(const char *ratestr, const char *lowerboundstr) : scalar(ratestr, lowerboundstr)
+{
+    // the strings are checked by scalar, and strtod rounds to nearest
+
+    lowerbound = dbl_up(strtod(lowerboundstr, nullptr));
+    rate = dbl_up(strtod(ratestr, nullptr));
+
+    for (uint x = 0; x < 3; ++x) {
+        for (uint y = 0; y < 3; ++y) {
+            logpxy.at(3 * x + y) = dbl_logupper(dbl_up(double(pxynumerator(x, y)) / double(pxydenominator)));
+        }
+    }
+
+    for (uint i = 0; i < 9; ++i) {
+        betalower.at(i).fill(0);
+        betaupper.at(i).fill(0);
+    }
+
+    for (uint p = 0; p < 6; ++p) {
+        for (uint x = 0; x < 3; ++x) {
+            qxpowers.at(p).at(x).fill(0);
+            qypowers.at(p).at(x).fill(0);
+        }
+    }
+}
+
+template <typename Backend>
+BatchVerifier<Backend>::~BatchVerifier()
+{
+    CHECK(count == 0);
+    batchleafs += leafcount;
+    batchescalations += escalations;
+}
+
+template <typename Backend>
+bool BatchVerifier<Backend>::verify(const qxybounds_t &leafqxybounds, const leaf_t &leaf, result_t &result)
+{
+    // store the leaf in the next lane; the fixed-point coordinates and 2^-leafexponent scalings are exact in double
+    // precision, and the conversion of the 56-bit numbers is a single rounding
+
+    const uint lane = count++;
+    qxybounds.at(lane) = leafqxybounds;
+    leafs.at(lane) = leaf;
+    results.at(lane) = &result;
+    alphalower.at(lane) = dbl_down(std::ldexp(double(leaf.alpha), -leafexponent));
+    alphaupper.at(lane) = dbl_up(std::ldexp(double(leaf.alpha), -leafexponent));
+
+    for (uint i = 0; i < 9; ++i) {
+        betalower.at(i).at(lane) = dbl_down(std::ldexp(double(leaf.beta.at(i)), -leafexponent));
+        betaupper.at(i).at(lane) = dbl_up(std::ldexp(double(leaf.beta.at(i)), -leafexponent));
+    }
+
+    // the lanes have six extreme points each, where missing points repeat the last one (which leaves the minimum
+    // unchanged)
+
+    extremepoints_t qxextremepoints;
+    extremepoints_t qyextremepoints;
+    findextremepoints(leafqxybounds, 0, qxextremepoints);
+    findextremepoints(leafqxybounds, 3, qyextremepoints);
+    CHECK((qxextremepoints.size() != 0) && (qyextremepoints.size() != 0));
+
+    for (uint p = 0; p < 6; ++p) {
+        const std::array<int32_t, 3> &qx = *(qxextremepoints.begin() + std::min<size_t>(p, qxextremepoints.size() - 1));
+        const std::array<int32_t, 3> &qy = *(qyextremepoints.begin() + std::min<size_t>(p, qyextremepoints.size() - 1));
+
+        for (uint x = 0; x < 3; ++x) {
+            qxpowers.at(p).at(x).at(lane) = std::ldexp(double(qx.at(x)), -fixedpointexponent);
+            qypowers.at(p).at(x).at(lane) = std::ldexp(double(qy.at(x)), -fixedpointexponent);
+        }
+    }
+
+    if (count == batchlanes) {
+        finish();
+    }
+
+    return true;
+}
+
+template <typename Backend>
+void BatchVerifier<Backend>::finish()
+{
+    if (count == 0) {
+        return;
+    }
+
+    // lower bounds of Q^{1-\alpha} for every coordinate, where 1 - \alpha <= 1 - alphalower and log(Q) <= 0
+
+    for (std::array<std::array<lanes_t, 3>, 6> *powers : {&qxpowers, &qypowers}) {
+        for (uint p = 0; p < 6; ++p) {
+            for (uint x = 0; x < 3; ++x) {
+                lanes_t &lanes = powers->at(p).at(x);
+
+                for (uint lane = 0; lane < batchlanes; ++lane) {
+                    const double coordinate = lanes[lane];
+                    const double logarithm = dbl_loglower((coordinate > 0) ? coordinate : 1.0);
+                    const double power = dbl_explower(dbl_down(dbl_up(1 - alphalower[lane]) * logarithm));
+                    lanes[lane] = (coordinate > 0) ? power : 0.0;
+                }
+            }
+        }
+    }
+
+    // lower bound of D, with qyweights(x) = \sum_y Q_Y(y)^{1-\alpha} \beta(x,y) as in Verifier::verify (the powers
+    // are nonnegative, so multiplying the lower bounds gives a lower bound)
+
+    for (uint p = 0; p < 6; ++p) {
+        for (uint x = 0; x < 3; ++x) {
+            lanes_t &weights = qyweights.at(p).at(x);
+
+            for (uint lane = 0; lane < batchlanes; ++lane) {
+                double sum = 0;
+
+                for (uint y = 0; y < 3; ++y) {
+                    sum = dbl_down(sum + dbl_down(qypowers[p][y][lane] * betalower[3 * x + y][lane]));
+                }
+
+                weights[lane] = sum;
+            }
+        }
+    }
+
+    qxybetamin.fill(HUGE_VAL);
+
+    for (uint px = 0; px < 6; ++px) {
+        for (uint py = 0; py < 6; ++py) {
+            for (uint lane = 0; lane < batchlanes; ++lane) {
+                double sum = 0;
+
+                for (uint x = 0; x < 3; ++x) {
+                    sum = dbl_down(sum + dbl_down(qxpowers[px][x][lane] * qyweights[py][x][lane]));
+                }
+
+                qxybetamin[lane] = (sum < qxybetamin[lane]) ? sum : qxybetamin[lane];
+            }
+        }
+    }
+
+    // upper bound of the P-term and lower bound of the value
+
+    for (uint lane = 0; lane < batchlanes; ++lane) {
+        const double alphalane = alphalower[lane];
+        const double alphaupperlane = alphaupper[lane];
+        double sum = 0;
+
+        for (uint i = 0; i < 9; ++i) {
+            double term = dbl_expupper(dbl_up(alphalane * logpxy[i]));
+            term = dbl_logupper(dbl_up(term + betaupper[i][lane]));
+            term = dbl_expupper(dbl_divupper(term, alphalane, alphaupperlane));
+            sum = dbl_up(sum + term);
+        }
+
+        pterm[lane] = dbl_expupper(dbl_mulupper(dbl_logupper(sum), alphalane, alphaupperlane));
+    }
+
+    for (uint lane = 0; lane < batchlanes; ++lane) {
+        // P-term - D is positive (see Verifier::verify), so its logarithm is bounded by that of its upper bound,
+        // which must be a normal number
+
+        const double difference = dbl_up(pterm[lane] - qxybetamin[lane]);
+        const double safedifference = (difference >= DBL_MIN) ? difference : 1.0;
+        const double numerator = dbl_up(dbl_logupper(safedifference) + dbl_up(dbl_up(1 - alphalower[lane]) * rate));
+        const double result = -dbl_divupper(numerator, alphalower[lane], alphaupper[lane]);
+        value[lane] = ((difference >= DBL_MIN) && (difference < HUGE_VAL)) ? result : -HUGE_VAL;
+    }
+
+    // write the conclusive lanes (within the range that Verifier::verify checks) and verify the others with Backend
+
+    for (uint lane = 0; lane < count; ++lane) {
+        const bool regular = (alphalower.at(lane) > 0.001) && (alphaupper.at(lane) < 0.999) && std::all_of(betaupper.begin(), betaupper.end(), [&](const lanes_t &lanes) { return lanes.at(lane) < 9; });
+        ++leafcount;
+
+        if (regular && (value.at(lane) > lowerbound)) {
+            // a double has 53 bits, so the 63-bit mantissa is exact
+
+            result_t &result = *results.at(lane);
+            int exponent = 0;
+            result.mantissa = int64_t(std::ldexp(std::frexp(value.at(lane), &exponent), 63));
+            result.exponent = (result.mantissa != 0) ? (exponent - 63) : 0;
+            result.text.at(0) = '\0';
+
+            if (!resultsquiet) {
+                CHECK(dd_snprintf(result.text.data(), result.text.size(), "%.20RDf", dd_t{value.at(lane), 0}) < int(result.text.size()));
+            }
+
+            continue;
+        }
+
+        ++escalations;
+        CHECK(scalar.verify(qxybounds.at(lane), leafs.at(lane), *results.at(lane)));
+    }
+
+    count = 0;
+}
+
+// the parameters of a run: those of the certificate, which --rate and --lowerbound have to match if they are given,
+// or for a certificate without parameters those of the options (by default those of the original certificate)
+
+// whether a parameter is a number that MPFR reads completely, into value and rounded to its precision; returns the
+// ternary value of the rounding in inexact
+
+static bool readparameter(mpfr_ptr value, const std::string &parameter, int &inexact)
+{
+    char *end = nullptr;
+    inexact = mpfr_strtofr(value, parameter.c_str(), &end, 0, MPFR_RNDN);
+    return (end != parameter.c_str()) && (*end == '\0');
+}
+
+static bool sameparameter(const std::string &a, const std::string &b)
+{
+    Mympfr<256> avalue;
+    Mympfr<256> bvalue;
+    int inexact = 0;
+    return readparameter(avalue, a, inexact) && readparameter(bvalue, b, inexact) && (mpfr_cmp(avalue, bvalue) == 0);
+}
+
+static bool resolveparameters(const parameters_t &certificate, const parameters_t &options, parameters_t &parameters)
+{
+    parameters.rate = !certificate.rate.empty() ? certificate.rate : !options.rate.empty() ? options.rate : certificaterate;
+    parameters.lowerbound = !certificate.lowerbound.empty() ? certificate.lowerbound : !options.lowerbound.empty() ? options.lowerbound : certificatelowerbound;
+    return (options.rate.empty() || sameparameter(options.rate, parameters.rate)) && (options.lowerbound.empty() || sameparameter(options.lowerbound, parameters.lowerbound));
+}
+
+// the index of the first pair of --rates that is not two exact binary numbers in (0, 1), or the number of pairs
+
+static size_t invalidrate()
+{
+    Mympfr<256> value;
+    int inexact = 0;
+
+    for (size_t i = 0; i < resultsrates.size(); ++i) {
+        for (const std::string &parameter : {resultsrates.at(i).rate, resultsrates.at(i).lowerbound}) {
+            if (!readparameter(value, parameter, inexact) || (inexact != 0) || (mpfr_cmp_si(value, 0) <= 0) || (mpfr_cmp_si(value, 1) >= 0)) {
+                return i;
+            }
+        }
+    }
+
+    return resultsrates.size();
+}
+
+// command line options of the lower-bound programs
+
+struct options_t {
+    uint threads = 1;
+    const char *checkpoint = nullptr; // file for checkpoints of a serial run, or nullptr
+    bool resume = false;
+    bool adaptive = false;
+    bool batch = false;
+    const char *stats = nullptr; // file for the JSON summary of --stats, or nullptr
+    bool quiet = false;
+    const char *log = nullptr;   // file for the raw values of --log, or nullptr
+    const char *rates = nullptr; // file with the further pairs of --rates, or nullptr
+    parameters_t parameters;     // of --rate and --lowerbound, empty if not given
+};
+
+template <typename LeafVerifier, typename Format>
+static void run(const options_t &options, const parameters_t &parameters, const Format &format, size_t certificatesize)
+{
+    const char *ratestr = parameters.rate.c_str();
+    const char *lowerboundstr = parameters.lowerbound.c_str();
+
+    if (options.checkpoint != nullptr) {
+        LeafVerifier verifier(ratestr, lowerboundstr);
+        Checkpoint checkpoint(options.checkpoint, certificatesize);
+        traverse(verifier, format, checkpoint, options.resume);
+    } else if ((options.threads == 1) && !options.batch) {
+        LeafVerifier verifier(ratestr, lowerboundstr);
+        traverse(verifier, format);
+    } else {
+        traverseparallel<LeafVerifier>(options.threads, format, ratestr, lowerboundstr);
+    }
+
+    // the hit rates of the caches are diagnostics, like the statistics
+
+    if (statsenabled) {
+        printcounters("log", logcounters);
+        printcounters("power", powercounters);
+        printcounters("pterm", ptermcounters);
+    }
+}
+
+// a smallest value (rounded down to 63 bits) and its margin above a lower bound, as printed
+
+static void formatminimum(const result_t &result, const char *lowerboundstr, std::array<char, 64> &minimumtext, std::array<char, 64> &margintext)
+{
+    Mympfr<64> minimum;
+    Mympfr<128> margin;
+    CHECK(mpfr_set_si_2exp(minimum, long(result.mantissa), long(result.exponent), MPFR_RNDN) == 0);
+    CHECK(mpfr_strtofr(margin, lowerboundstr, nullptr, 0, MPFR_RNDN) == 0);
+    mpfr_sub(margin, minimum, margin, MPFR_RNDD);
+    CHECK(mpfr_snprintf(minimumtext.data(), minimumtext.size(), "%.20RDf", static_cast<mpfr_srcptr>(minimum)) < int(minimumtext.size()));
+    CHECK(mpfr_snprintf(margintext.data(), margintext.size(), "%.20RDf", static_cast<mpfr_srcptr>(margin)) < int(margintext.size()));
+}
+
+// with --quiet or --log: the smallest value with its leaf (counted from 0) and its margin above the lower bound, and
+// the digest of all values (see results.h)
+
+static void printresults(const char *lowerboundstr)
+{
+    std::array<char, 64> minimumtext;
+    std::array<char, 64> margintext;
+    formatminimum(resultsminimum, lowerboundstr, minimumtext, margintext);
+    fprintf(stderr, "minimum: %s at leaf %llu of %llu, margin %s\n", minimumtext.data(), static_cast<unsigned long long>(resultsminimumleaf), static_cast<unsigned long long>(resultscount), margintext.data());
+    fprintf(stderr, "digest: %016llx\n", static_cast<unsigned long long>(resultsdigest));
+}
+
+// with --rates: whether every pair holds, and the smallest value for its rate with the margin above its lower bound
+
+static void printrates()
+{
+    for (const rateresult_t &total : resultsrates) {
+        std::array<char, 64> minimumtext;
+        std::array<char, 64> margintext;
+        formatminimum(total.minimum, total.lowerbound.c_str(), minimumtext, margintext);
+
+        if (total.failures == 0) {
+            fprintf(stderr, "rate %s, lower bound %s: holds, minimum %s, margin %s\n", total.rate.c_str(), total.lowerbound.c_str(), minimumtext.data(), margintext.data());
+        } else {
+            fprintf(stderr, "rate %s, lower bound %s: fails at %llu of %llu leaves, minimum %s, margin %s\n", total.rate.c_str(), total.lowerbound.c_str(), static_cast<unsigned long long>(total.failures), static_cast<unsigned long long>(total.leafs), minimumtext.data(), margintext.data());
+        }
+    }
+}
+
+template <typename LeafVerifier>
+static void run(const options_t &options, const parameters_t &parameters, const StreamedInput &input)
+{
+    // checkpoints identify the certificate by the size of its files
+
+    const bool binary = isbinary(input.data(), input.wait(binarymagic.size()));
+
+    if (input.mapped() && binary) {
+        run<LeafVerifier>(options, parameters, BinaryFormat(input.data(), input.size()), input.filesize());
+    } else if (input.mapped()) {
+        run<LeafVerifier>(options, parameters, TextFormat(input.data(), input.size()), input.filesize());
+    } else if (binary) {
+        run<LeafVerifier>(options, parameters, StreamedFormat<BinaryFormat>(input), input.filesize());
+    } else {
+        run<LeafVerifier>(options, parameters, StreamedFormat<TextFormat>(input), input.filesize());
+    }
+}
+
+// verification with Backend, or with --adaptive (if FastBackend is a different backend) with FastBackend first
+
+template <typename Backend, typename FastBackend = Backend>
+int verifiermain(int argc, char **argv)
+{
+    static const bool adaptivebackend = !std::is_same<Backend, FastBackend>::value;
+    std::vector<const char *> filenames;
+    options_t options;
+    bool usage = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if ((std::string(argv[i]) == "--threads") && (i + 1 < argc)) {
+            if (!parsecount(argv[++i], maximumthreads, options.threads)) {
+                usage = true;
+                break;
+            }
+
+            options.threads = (options.threads != 0) ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+            continue;
+        }
+
+        if ((std::string(argv[i]) == "--checkpoint") && (i + 1 < argc)) {
+            options.checkpoint = argv[++i];
+            continue;
+        }
+
+        if ((std::string(argv[i]) == "--stats") && (i + 1 < argc)) {
+            options.stats = argv[++i];
+            continue;
+        }
+
+        if ((std::string(argv[i]) == "--rate") && (i + 1 < argc)) {
+            options.parameters.rate = argv[++i];
+            continue;
+        }
+
+        if ((std::string(argv[i]) == "--lowerbound") && (i + 1 < argc)) {
+            options.parameters.lowerbound = argv[++i];
+            continue;
+        }
+
+        if (std::string(argv[i]) == "--resume") {
+            options.resume = true;
+            continue;
+        }
+
+        if (std::string(argv[i]) == "--quiet") {
+            options.quiet = true;
+            continue;
+        }
+
+        if ((std::string(argv[i]) == "--log") && (i + 1 < argc)) {
+            options.log = argv[++i];
+            continue;
+        }
+
+        if ((std::string(argv[i]) == "--rates") && (i + 1 < argc)) {
+            options.rates = argv[++i];
+            continue;
+        }
+
+        if (std::string(argv[i]) == "--batch") {
+            options.batch = true;
+            continue;
+        }
+
+        if ((std::string(argv[i]) == "--adaptive") && adaptivebackend) {
+            options.adaptive = true;
+            continue;
+        }
+
+        if (argv[i][0] != '-') {
+            filenames.push_back(argv[i]);
+            continue;
+        }
+
+        usage = true;
+        break;
+    }
+
+    // checkpoints are only written by the serial traversal, which --batch does not use, and they do not keep the
+    // minimum and the digest of --quiet and --log or the values for --rates; the batch only computes the values for
+    // the rate of the certificate
+
+    const bool summary = options.quiet || (options.log != nullptr);
+
+    if (usage || (options.resume && (options.checkpoint == nullptr)) || ((options.checkpoint != nullptr) && ((options.threads != 1) || options.batch || summary || (options.rates != nullptr))) || (options.batch && (options.adaptive || (options.rates != nullptr)))) {
+        printf("usage: %s [--threads N | --checkpoint FILE [--resume]] [--rate 0x0.hhh] [--lowerbound 0x0.hhh] [--stats FILE] [--quiet] [--log FILE] [--rates FILE] [--batch%s] [input.txt | input.bin | part ...]\n", argv[0], adaptivebackend ? " | --adaptive" : "");
+        return 1;
+    }
+
+    // the parts of a certificate (each possibly compressed) are read in order as one stream
+
+    if (filenames.empty()) {
+        filenames.push_back("input.txt");
+    }
+
+    const StreamedInput input(filenames);
+
+    if (!input.reserved()) {
+        printf("cannot reserve %zu bytes of address space for the decompressed certificate\n", streamcapacity);
+        return 1;
+    }
+
+    if (!input.valid()) {
+        printf("cannot open %s\n", input.failedname());
+        return 1;
+    }
+
+    parameters_t parameters;
+
+    if (!resolveparameters(certificateparameters(input), options.parameters, parameters)) {
+        printf("the certificate is for rate %s and lower bound %s\n", parameters.rate.c_str(), parameters.lowerbound.c_str());
+        return 1;
+    }
+
+    if ((options.rates != nullptr) && !resultsreadrates(options.rates)) {
+        printf("cannot read %s\n", options.rates);
+        return 1;
+    }
+
+    if (invalidrate() != resultsrates.size()) {
+        printf("pair %llu of %s is not two exact binary numbers in (0, 1)\n", static_cast<unsigned long long>(invalidrate()), options.rates);
+        return 1;
+    }
+
+    if ((options.log != nullptr) && !resultsopen(options.log)) {
+        printf("cannot write %s\n", options.log);
+        return 1;
+    }
+
+    if (options.stats != nullptr) {
+        enablestats();
+    }
+
+    resultsquiet = options.quiet;
+
+    if (options.batch) {
+        run<BatchVerifier<Backend>>(options, parameters, input);
+        const uint64_t leafs = batchleafs.load();
+        const uint64_t escalations = batchescalations.load();
+        fprintf(stderr, "%llu of %llu leaves escalated from the batch (%.1f%%)\n", static_cast<unsigned long long>(escalations), static_cast<unsigned long long>(leafs), (leafs != 0) ? (100.0 * double(escalations) / double(leafs)) : 0.0);
+    } else if (options.adaptive) {
+        run<AdaptiveVerifier<FastBackend, Backend>>(options, parameters, input);
+        const uint64_t leafs = adaptiveleafs.load();
+        const uint64_t escalations = adaptiveescalations.load();
+        fprintf(stderr, "%llu of %llu leaves escalated (%.1f%%)\n", static_cast<unsigned long long>(escalations), static_cast<unsigned long long>(leafs), (leafs != 0) ? (100.0 * double(escalations) / double(leafs)) : 0.0);
+    } else {
+        run<Verifier<Backend>>(options, parameters, input);
+    }
+
+    if (summary) {
+        CHECK(resultsclose());
+        printresults(parameters.lowerbound.c_str());
+    }
+
+    printrates();
+
+    if (options.stats != nullptr) {
+        FILE *file = fopen(options.stats, "w");
+        CHECK(file != nullptr);
+        printstats(file);
+        CHECK(fclose(file) == 0);
+    }
+
+    printf("finish\n");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,38 @@
+import concurrent.futures
+import glob
+import os
+import subprocess
+import sys
+
+# runs the shards written by 'generatewl --shards N' in parallel kernels; a shard is verified if its output consists
+# of 'True' lines followed by 'finish'
+
+def verifyshard(filename):
+    process = subprocess.run(['math', '-script', filename], stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    lines = process.stdout.split()
+    return (process.returncode == 0) and (len(lines) >= 3) and (lines[-1] == 'finish') and all(line == 'True' for line in lines[:-1])
+
+if len(sys.argv) > 3:
+    print('usage: {} [kernels] [input.wl]'.format(sys.argv[0]))
+    sys.exit(1)
+
+kernels = int(sys.argv[1]) if len(sys.argv) >= 2 else os.cpu_count()
+stem = (sys.argv[2] if len(sys.argv) == 3 else 'input.wl')[:-len('.wl')]
+filenames = sorted(glob.glob(stem + '-*.wl'), key=lambda filename: int(filename[len(stem) + 1:-len('.wl')]))
+
+if not filenames:
+    print('no shards {}-*.wl'.format(stem))
+    sys.exit(1)
+
+failed = 0
+
+with concurrent.futures.ThreadPoolExecutor(max_workers=kernels) as executor:
+    for filename, verified in zip(filenames, executor.map(verifyshard, filenames)):
+        print('{} {}'.format(filename, 'True' if verified else 'False'))
+        failed += 0 if verified else 1
+
+if failed != 0:
+    print('{} of {} shards failed'.format(failed, len(filenames)))
+    sys.exit(1)
+
+print('finish')
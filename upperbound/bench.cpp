@@ -0,0 +1,48 @@
+#include <chrono>
+
+#include "../common/ddbackend.h"
+#include "../common/mpfibackend.h"
+#include "../common/mpfrbackend.h"
+#include "verifier.h"
+
+// benchmark of Verifier::verify for every backend and several precisions, on the R_XY for (57) and for (58)
+
+static const double benchseconds = 0.5;
+
+template <typename Backend>
+static void benchverify(const char *name, const char *ratestr, const char *upperboundstr, const rxystr_t &rxystr, const char *backendname, int precision)
+{
+    Verifier<Backend> verifier;
+    results_t results;
+    uint64_t calls = 0;
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    double seconds = 0.0;
+
+    do {
+        CHECK(verifier.verify(ratestr, upperboundstr, rxystr, results));
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        ++calls;
+    } while (seconds < benchseconds);
+
+    printf("%-4s %-5s %5d %10.0f %10.2f\n", name, backendname, precision, 1e9 * seconds / double(calls), double(verifier.logs()) / double(calls));
+}
+
+static void benchrxy(const char *name, const char *ratestr, const char *upperboundstr, const rxystr_t &rxystr)
+{
+    // the check that R_XY is a probability mass function needs the 56-bit numbers to be exact
+
+    benchverify<MpfiBackend<64>>(name, ratestr, upperboundstr, rxystr, "mpfi", 64);
+    benchverify<MpfiBackend<128>>(name, ratestr, upperboundstr, rxystr, "mpfi", 128);
+    benchverify<MpfrBackend<64>>(name, ratestr, upperboundstr, rxystr, "mpfr", 64);
+    benchverify<MpfrBackend<128>>(name, ratestr, upperboundstr, rxystr, "mpfr", 128);
+    benchverify<DdBackend>(name, ratestr, upperboundstr, rxystr, "dd", 106);
+}
+
+int main()
+{
+    printf("rxy  backend  bits    ns/call  logs/call\n");
+    benchrxy("A", rateA, upperboundA, rxyA);
+    benchrxy("B", rateB, upperboundB, rxyB);
+    printf("finish\n");
+    return 0;
+}
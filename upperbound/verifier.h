@@ -0,0 +1,385 @@
+#ifndef VERIFIER_H
+#define VERIFIER_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <sys/types.h>
+#include <thread>
+#include <vector>
+
+#include "../common/arguments.h"
+#include "../common/backend.h"
+#include "../common/mpfrbackend.h"
+
+using rxystr_t = std::array<const char *, 9>;
+using result_t = std::array<char, 32>;
+using results_t = std::array<result_t, 4>;
+
+// verification of (62) and (63) for a given R_XY, for any number backend (see backend.h): both divergences are
+// computed as upper bounds and returned in results, followed by their margins below the rate and the upper bound
+// (as lower bounds); verify returns whether both margins are positive
+
+template <typename Backend>
+class Verifier
+{
+  public:
+    using number_t = typename Backend::number_t;
+
+    Verifier();
+
+    bool verify(const char *ratestr, const char *upperboundstr, const rxystr_t &rxystr, results_t &results);
+    uint64_t logs() const { return logcount; }
+
+  private:
+    void log(number_t &result, const number_t &a, rounding_t rounding);
+
+    number_t rate;
+    number_t tmpa;
+    number_t tmpb;
+    number_t upperbound;
+    std::array<number_t, 3> rx;
+    std::array<number_t, 3> ry;
+    std::array<number_t, 9> pxy;
+    std::array<number_t, 9> rxy;
+    uint64_t logcount = 0;
+};
+
+template <typename Backend>
+Verifier<Backend>::Verifier()
+{
+    for (uint x = 0; x < 3; ++x) {
+        for (uint y = 0; y < 3; ++y) {
+            Backend::setsi(tmpa, (x == y) ? 6 : 9997);
+            Backend::divsi(pxy.at(3 * x + y), tmpa, 60000, down);
+        }
+    }
+}
+
+template <typename Backend>
+void Verifier<Backend>::log(number_t &result, const number_t &a, rounding_t rounding)
+{
+    Backend::log(result, a, rounding);
+    ++logcount;
+}
+
+template <typename Backend>
+bool Verifier<Backend>::verify(const char *ratestr, const char *upperboundstr, const rxystr_t &rxystr, results_t &results)
+{
+    // initialize values and perform basic checks
+
+    Backend::setstr(rate, ratestr);
+    CHECK(Backend::cmpsi(rate, 0) > 0);
+    CHECK(Backend::cmpsi(rate, 1) < 0);
+
+    Backend::setstr(upperbound, upperboundstr);
+    CHECK(Backend::cmpsi(upperbound, 0) > 0);
+    CHECK(Backend::cmpsi(upperbound, 1) < 0);
+
+    for (uint i = 0; i < 9; ++i) {
+        Backend::setstr(rxy.at(i), rxystr.at(i));
+        CHECK(Backend::cmpsi(rxy.at(i), 0) > 0);
+        CHECK(Backend::cmpsi(rxy.at(i), 1) < 0);
+    }
+
+    // check that rxy is a probability mass function
+
+    Backend::setsi(tmpa, -1);
+
+    for (uint i = 0; i < 9; ++i) {
+        Backend::add(tmpa, tmpa, rxy.at(i), exact);
+    }
+
+    CHECK(Backend::iszero(tmpa));
+
+    // compute rx and ry
+
+    for (uint x = 0; x < 3; ++x) {
+        Backend::setzero(rx.at(x));
+
+        for (uint y = 0; y < 3; ++y) {
+            Backend::add(rx.at(x), rx.at(x), rxy.at(3 * x + y), exact);
+        }
+    }
+
+    for (uint y = 0; y < 3; ++y) {
+        Backend::setzero(ry.at(y));
+
+        for (uint x = 0; x < 3; ++x) {
+            Backend::add(ry.at(y), ry.at(y), rxy.at(3 * x + y), exact);
+        }
+    }
+
+    // check that D(rxy||rxry) < rate
+
+    Backend::setzero(tmpa);
+
+    for (uint x = 0; x < 3; ++x) {
+        for (uint y = 0; y < 3; ++y) {
+            Backend::mul(tmpb, rx.at(x), ry.at(y), down);
+            Backend::div(tmpb, rxy.at(3 * x + y), tmpb, up);
+            log(tmpb, tmpb, up);
+            Backend::mul(tmpb, rxy.at(3 * x + y), tmpb, up);
+            Backend::add(tmpa, tmpa, tmpb, up);
+        }
+    }
+
+    const bool ratemargin = (Backend::cmp(tmpa, rate) < 0);
+    CHECK(Backend::snprintf(results.at(0).data(), results.at(0).size(), "%.20RUf", tmpa, up) < int(results.at(0).size()));
+    Backend::sub(tmpb, rate, tmpa, down);
+    CHECK(Backend::snprintf(results.at(2).data(), results.at(2).size(), "%.6RDe", tmpb, down) < int(results.at(2).size()));
+
+    // check that D(rxy||pxy) < upperbound
+
+    Backend::setzero(tmpa);
+
+    for (uint i = 0; i < 9; ++i) {
+        Backend::div(tmpb, rxy.at(i), pxy.at(i), up);
+        log(tmpb, tmpb, up);
+        Backend::mul(tmpb, rxy.at(i), tmpb, up);
+        Backend::add(tmpa, tmpa, tmpb, up);
+    }
+
+    const bool upperboundmargin = (Backend::cmp(tmpa, upperbound) < 0);
+    CHECK(Backend::snprintf(results.at(1).data(), results.at(1).size(), "%.20RUf", tmpa, up) < int(results.at(1).size()));
+    Backend::sub(tmpb, upperbound, tmpa, down);
+    CHECK(Backend::snprintf(results.at(3).data(), results.at(3).size(), "%.6RDe", tmpb, down) < int(results.at(3).size()));
+    return ratemargin && upperboundmargin;
+}
+
+static const char *rateA = "0x0.079d"; // 3898 / 2^17
+static const char *rateB = "0x0.07c8"; // 3984 / 2^17
+
+static const char *upperboundA = "0x0.d02a7208f52317"; // 58593464420737815 / 2^56
+static const char *upperboundB = "0x0.cf6aa03d0f0253"; // 58382556630811219 / 2^56
+
+static const rxystr_t rxyA = {"0x0.00d18e2d53dba4", "0x0.6c6ebcb6c6ea40", "0x0.6c6ebcb6c6ea40",
+                              "0x0.006ff71d804e2a", "0x0.03d405476786bd", "0x0.0ee47fcda75307",
+                              "0x0.006ff71d804e2a", "0x0.0ee47fcda75307", "0x0.03d405476786bd"};
+
+static const rxystr_t rxyB = {"0x0.0184ae0a6be14a", "0x0.35ba25f4e1fd7f", "0x0.870eb8aa072ec5",
+                              "0x0.02598735ff8940", "0x0.057e6f74c876f3", "0x0.35ba25f4e1fd7f",
+                              "0x0.00422176958a36", "0x0.02598735ff8940", "0x0.0184ae0a6be14a"};
+
+// a record of an input file: the rate, the upper bound and R_XY, as exact hexadecimal numbers like the constants above,
+// and whether it is valid (see validrecord)
+
+struct record_t {
+    std::string rate;
+    std::string upperbound;
+    std::array<std::string, 9> rxy;
+    bool valid = false;
+};
+
+// whether a number of a record is a multiple of 2^-64 in (0, 1), which every backend holds exactly, as it does the sums
+// of such numbers in the verification as long as they stay below 1
+
+static bool validnumber(mpfr_ptr value, const std::string &string)
+{
+    char *end = nullptr;
+
+    if ((mpfr_strtofr(value, string.c_str(), &end, 0, MPFR_RNDN) != 0) || (end == string.c_str()) || (*end != '\0')) {
+        return false;
+    }
+
+    if ((mpfr_cmp_si(value, 0) <= 0) || (mpfr_cmp_si(value, 1) >= 0)) {
+        return false;
+    }
+
+    Mympfr<128> scaled;
+    CHECK(mpfr_mul_2si(scaled, value, 64, MPFR_RNDN) == 0);
+    return mpfr_integer_p(scaled) != 0;
+}
+
+// whether all numbers of a record are valid and R_XY sums to exactly 1, so that the verification cannot abort
+
+static bool validrecord(const record_t &record)
+{
+    Mympfr<128> value;
+    Mympfr<128> sum;
+
+    if (!validnumber(value, record.rate) || !validnumber(value, record.upperbound)) {
+        return false;
+    }
+
+    mpfr_set_si(sum, -1, MPFR_RNDN);
+
+    for (const std::string &rxy : record.rxy) {
+        if (!validnumber(value, rxy)) {
+            return false;
+        }
+
+        CHECK(mpfr_add(sum, sum, value, MPFR_RNDN) == 0);
+    }
+
+    return mpfr_zero_p(sum) != 0;
+}
+
+static bool readrecords(const char *filename, std::vector<record_t> &records)
+{
+    // whitespace-separated records of 11 numbers, usually one per line; a longer token than fits into number would be
+    // split, so the file is not valid
+
+    FILE *file = fopen(filename, "r");
+
+    if (file == nullptr) {
+        return false;
+    }
+
+    std::array<char, 256> number;
+    std::vector<std::string> numbers;
+    bool truncated = false;
+
+    while (fscanf(file, "%255s", number.data()) == 1) {
+        numbers.push_back(number.data());
+        truncated = truncated || (strlen(number.data()) == number.size() - 1);
+    }
+
+    const bool valid = (ferror(file) == 0) && !truncated && !numbers.empty() && (numbers.size() % 11 == 0);
+    fclose(file);
+
+    for (size_t i = 0; valid && (i < numbers.size()); i += 11) {
+        records.emplace_back();
+        records.back().rate = numbers.at(i);
+        records.back().upperbound = numbers.at(i + 1);
+        std::copy(numbers.begin() + long(i) + 2, numbers.begin() + long(i) + 11, records.back().rxy.begin());
+        records.back().valid = validrecord(records.back());
+    }
+
+    return valid;
+}
+
+// verification of the records of a file on threads that take the next record in turn, every thread with its own
+// verifier; the results are printed in the order of the file, one line per record with its index (counted from 0),
+// whether both margins are positive, and both divergences, each followed by its margin, or only its index and invalid
+// if the record is not valid; returns the number of invalid records
+
+template <typename Backend>
+static uint64_t verifyrecords(uint threads, const std::vector<record_t> &records)
+{
+    std::vector<results_t> results(records.size());
+    std::vector<char> holds(records.size(), 0);
+    std::atomic<size_t> next{0};
+
+    auto work = [&]() {
+        Verifier<Backend> verifier;
+
+        for (size_t i = next++; i < records.size(); i = next++) {
+            const record_t &record = records.at(i);
+            rxystr_t rxystr;
+
+            if (!record.valid) {
+                continue;
+            }
+
+            for (uint j = 0; j < 9; ++j) {
+                rxystr.at(j) = record.rxy.at(j).c_str();
+            }
+
+            holds.at(i) = verifier.verify(record.rate.c_str(), record.upperbound.c_str(), rxystr, results.at(i)) ? 1 : 0;
+        }
+    };
+
+    std::vector<std::thread> pool;
+
+    for (uint worker = 1; worker < threads; ++worker) {
+        pool.emplace_back(work);
+    }
+
+    work();
+
+    for (std::thread &thread : pool) {
+        thread.join();
+    }
+
+    uint64_t held = 0;
+    uint64_t invalid = 0;
+
+    for (size_t i = 0; i < records.size(); ++i) {
+        const results_t &result = results.at(i);
+
+        if (!records.at(i).valid) {
+            printf("%llu invalid\n", static_cast<unsigned long long>(i));
+            ++invalid;
+            continue;
+        }
+
+        printf("%llu %s %s %s %s %s\n", static_cast<unsigned long long>(i), (holds.at(i) != 0) ? "holds" : "fails", result.at(0).data(), result.at(2).data(), result.at(1).data(), result.at(3).data());
+        held += uint64_t(holds.at(i));
+    }
+
+    fprintf(stderr, "%llu of %llu records hold (%.1f%%)\n", static_cast<unsigned long long>(held), static_cast<unsigned long long>(records.size()), 100.0 * double(held) / double(records.size()));
+
+    if (invalid != 0) {
+        fprintf(stderr, "%llu records are invalid\n", static_cast<unsigned long long>(invalid));
+    }
+
+    return invalid;
+}
+
+// verification of the R_XY for (57) and (58), or of the records of an input file
+
+template <typename Backend>
+int verifiermain(int argc, char **argv)
+{
+    uint threads = 1;
+    const char *filename = nullptr;
+    bool usage = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if ((std::string(argv[i]) == "--threads") && (i + 1 < argc)) {
+            if (!parsecount(argv[++i], maximumthreads, threads)) {
+                usage = true;
+                break;
+            }
+
+            threads = (threads != 0) ? threads : std::max(1u, std::thread::hardware_concurrency());
+            continue;
+        }
+
+        if ((argv[i][0] != '-') && (filename == nullptr)) {
+            filename = argv[i];
+            continue;
+        }
+
+        usage = true;
+        break;
+    }
+
+    if (usage || ((threads != 1) && (filename == nullptr))) {
+        printf("usage: %s [[--threads N] records.txt]\n", argv[0]);
+        return 1;
+    }
+
+    if (filename != nullptr) {
+        std::vector<record_t> records;
+
+        if (!readrecords(filename, records)) {
+            printf("cannot read %s\n", filename);
+            return 1;
+        }
+
+        if (verifyrecords<Backend>(threads, records) != 0) {
+            return 1;
+        }
+
+        printf("finish\n");
+        return 0;
+    }
+
+    Verifier<Backend> verifier;
+    results_t results;
+
+    CHECK(verifier.verify(rateA, upperboundA, rxyA, results));
+    printf("%s\n%s\n", results.at(0).data(), results.at(1).data());
+    CHECK(verifier.verify(rateB, upperboundB, rxyB, results));
+    printf("%s\n%s\n", results.at(0).data(), results.at(1).data());
+    printf("finish\n");
+    return 0;
+}
+
+#endif